@@ -0,0 +1,96 @@
+#pragma once
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string_view>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+/**
+ * Shared helpers of the benchmarks.
+ *
+ * Benchmarks that need real game frames read them from the recording (a directory of
+ * 1920x1080 screenshots) that ASAPP_BENCH_RECORDING points to and skip themselves if
+ * it is not set. Crops of the frames, such as tribelog rows, are kept in subdirectories
+ * of the recording. Everything else runs on synthetic frames.
+ */
+namespace asa::bench
+{
+    inline const cv::Size FRAME_SIZE{1920, 1080};
+
+    /**
+     * @brief Gets the recording set through ASAPP_BENCH_RECORDING, empty if unset.
+     */
+    inline std::filesystem::path get_recording()
+    {
+        const char* env = std::getenv("ASAPP_BENCH_RECORDING");
+        return env ? std::filesystem::path(env) : std::filesystem::path();
+    }
+
+    /**
+     * @brief Loads the PNG images of a directory sorted by name, empty if there is
+     * no such directory.
+     */
+    inline std::vector<cv::Mat> load_images(const std::filesystem::path& dir,
+                                            const int flags = cv::IMREAD_COLOR)
+    {
+        std::vector<cv::Mat> ret;
+        if (dir.empty() || !std::filesystem::is_directory(dir)) { return ret; }
+
+        std::vector<std::filesystem::path> files;
+        for (const auto& entry: std::filesystem::directory_iterator(dir)) {
+            if (entry.path().extension() == ".png") { files.push_back(entry.path()); }
+        }
+        std::ranges::sort(files);
+        for (const auto& file: files) {
+            cv::Mat image = cv::imread(file.string(), flags);
+            if (!image.empty()) { ret.push_back(std::move(image)); }
+        }
+        return ret;
+    }
+
+    /**
+     * @brief Gets the frames of the recording sorted by name, empty if there is none.
+     */
+    inline const std::vector<cv::Mat>& get_recorded_frames()
+    {
+        static const std::vector<cv::Mat> frames = load_images(get_recording());
+        return frames;
+    }
+
+    /**
+     * @brief Gets the images of a subdirectory of the recording, e.g. the crops of
+     * tribelog rows in "tribelog_rows", empty if there are none.
+     */
+    inline std::vector<cv::Mat> get_recorded_crops(const std::string_view name,
+                                                   const int flags = cv::IMREAD_COLOR)
+    {
+        const std::filesystem::path recording = get_recording();
+        if (recording.empty()) { return {}; }
+        return load_images(recording / name, flags);
+    }
+
+    /**
+     * @brief Gets a frame of noise with blocks of the given colors scattered over it,
+     * so that the colors make up a realistic share of the pixels.
+     */
+    inline cv::Mat make_synthetic_frame(const std::vector<cv::Vec3b>& colors,
+                                        const cv::Size size = FRAME_SIZE)
+    {
+        cv::Mat frame(size, CV_8UC3);
+        std::mt19937 rng(42);
+        for (int y = 0; y < frame.rows; y++) {
+            uchar* row = frame.ptr<uchar>(y);
+            for (int x = 0; x < frame.cols * 3; x++) { row[x] = rng() & 0xFF; }
+        }
+
+        for (int i = 0; i < 200 && !colors.empty(); i++) {
+            const cv::Rect block(rng() % (size.width - 40), rng() % (size.height - 20),
+                                 40, 20);
+            frame(block).setTo(cv::Scalar(colors[i % colors.size()]));
+        }
+        return frame;
+    }
+}
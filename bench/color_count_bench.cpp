@@ -0,0 +1,68 @@
+#include "bench.h"
+#include "asa/vision/color_count.h"
+
+#include <benchmark/benchmark.h>
+#include <opencv2/core.hpp>
+
+namespace
+{
+    // the colors of the spoil timer and durability bars of a slot.
+    const std::vector<cv::Vec3b> COLORS{{1, 156, 136}, {1, 105, 83}, {0, 200, 190}};
+    constexpr int VARIANCE = 20;
+
+    std::vector<asa::vision::color_range> get_ranges(const size_t n)
+    {
+        std::vector<asa::vision::color_range> ret;
+        for (size_t i = 0; i < n; i++) {
+            ret.push_back(asa::vision::color_range::of(COLORS[i % COLORS.size()],
+                                                       VARIANCE));
+        }
+        return ret;
+    }
+
+    const cv::Mat& get_frame()
+    {
+        static const cv::Mat frame = asa::bench::make_synthetic_frame(COLORS);
+        return frame;
+    }
+
+    /**
+     * @brief The path every count took before, one mask per color OR'd together.
+     */
+    void count_opencv(benchmark::State& state)
+    {
+        const auto ranges = get_ranges(state.range(0));
+        for (auto _: state) {
+            cv::Mat combined = cv::Mat::zeros(get_frame().size(), CV_8U);
+            for (const auto& range: ranges) {
+                cv::Mat mask;
+                cv::inRange(get_frame(), range.low, range.high, mask);
+                combined |= mask;
+            }
+            benchmark::DoNotOptimize(cv::countNonZero(combined));
+        }
+        state.SetItemsProcessed(state.iterations() * get_frame().total());
+    }
+
+    void count_fused(benchmark::State& state, const bool avx2)
+    {
+        if (asa::vision::set_avx2_enabled(avx2) != avx2) {
+            return state.SkipWithError("AVX2 is not supported by the CPU or build.");
+        }
+
+        const auto ranges = get_ranges(state.range(0));
+        for (auto _: state) {
+            benchmark::DoNotOptimize(asa::vision::count_in_ranges(get_frame(), ranges));
+        }
+        state.SetItemsProcessed(state.iterations() * get_frame().total());
+        asa::vision::set_avx2_enabled(true);
+    }
+
+    void count_fused_scalar(benchmark::State& state) { count_fused(state, false); }
+
+    void count_fused_avx2(benchmark::State& state) { count_fused(state, true); }
+}
+
+BENCHMARK(count_opencv)->Arg(1)->Arg(3)->Unit(benchmark::kMillisecond);
+BENCHMARK(count_fused_scalar)->Arg(1)->Arg(3)->Unit(benchmark::kMillisecond);
+BENCHMARK(count_fused_avx2)->Arg(1)->Arg(3)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,51 @@
+#include "bench.h"
+#include "asa/game/frame.h"
+#include "asa/ui/components/slot.h"
+#include "asa/ui/storage/inventory_snapshot.h"
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+    // the colors of the weight text, spoil timer and quality of a slot.
+    const std::vector<cv::Vec3b> COLORS{{128, 231, 255}, {0, 214, 161}, {31, 166, 36}};
+
+    const std::vector<asa::item_slot>& get_slots()
+    {
+        // the slots of the local inventory, laid out as in base_inventory.
+        static const std::vector<asa::item_slot> slots = [] {
+            std::vector<asa::item_slot> ret;
+            for (int i = 0; i < 36; i++) {
+                ret.emplace_back(i, 178 + (i % 6) * 93, 239 + (i / 6) * 93);
+            }
+            return ret;
+        }();
+        return slots;
+    }
+
+    const asa::frame_ptr& get_inventory_frame()
+    {
+        static const asa::frame_ptr frame = [] {
+            const auto& recorded = asa::bench::get_recorded_frames();
+            return std::make_shared<const asa::frame>(
+                1, recorded.empty() ? asa::bench::make_synthetic_frame(COLORS)
+                                    : recorded.front());
+        }();
+        return frame;
+    }
+
+    /**
+     * @brief Decodes every slot of a page, with or without the items in them.
+     */
+    void inventory_snapshot(benchmark::State& state)
+    {
+        const bool with_items = state.range(0) != 0;
+        for (auto _: state) {
+            const asa::inventory_snapshot snapshot(get_slots(), get_inventory_frame(),
+                                                   with_items);
+            benchmark::DoNotOptimize(snapshot.get_first_empty());
+        }
+    }
+}
+
+BENCHMARK(inventory_snapshot)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,61 @@
+#include "asa/utility.h"
+#include "asa/items/items.h"
+
+#include <benchmark/benchmark.h>
+#include <opencv2/imgproc.hpp>
+
+namespace
+{
+    // the scales item.cpp applied to the exported 256x256 icons at startup.
+    constexpr float SCALE_INV = 0.24f;
+    constexpr float SCALE_NOTIF_EXPORT = 0.11f;
+
+    // an exported icon, an opaque square on a transparent background.
+    cv::Mat make_exported_icon()
+    {
+        cv::Mat icon(256, 256, CV_8UC4, cv::Scalar(0, 0, 0, 0));
+        icon(cv::Rect(48, 48, 160, 160)).setTo(cv::Scalar(40, 90, 200, 255));
+        return icon;
+    }
+
+    /**
+     * @brief The work every item constructor did before the icons were prescaled, an
+     * RGB icon and an alpha mask for both the inventory and the notification scale.
+     */
+    void scale_icons_at_startup(benchmark::State& state)
+    {
+        const cv::Mat icon = make_exported_icon();
+        for (auto _: state) {
+            for (const float scale: {SCALE_INV, SCALE_NOTIF_EXPORT}) {
+                cv::Mat rgba;
+                cv::Mat rgb;
+                const cv::Size size(icon.cols * scale, icon.rows * scale);
+                cv::resize(icon, rgba, size, 0, 0, cv::INTER_LINEAR);
+                cv::cvtColor(rgba, rgb, cv::COLOR_RGBA2RGB);
+                benchmark::DoNotOptimize(asa::utility::mask_alpha_channel(rgba));
+                benchmark::DoNotOptimize(rgb.data);
+            }
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    /**
+     * @brief Loads all items once, with the icons as they come from the asset pack.
+     * The time before is this plus the amount of items times scale_icons_at_startup.
+     */
+    void load_items(benchmark::State& state)
+    {
+        for (auto _: state) {
+            try {
+                asa::load_items();
+            } catch (const std::exception& e) {
+                state.SkipWithError(e.what());
+                return;
+            }
+        }
+        state.counters["items"] = static_cast<double>(asa::get_all_items().size());
+    }
+}
+
+BENCHMARK(scale_icons_at_startup)->Unit(benchmark::kMicrosecond);
+BENCHMARK(load_items)->Iterations(1)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,70 @@
+#include "bench.h"
+#include "asa/core/thread_pool.h"
+#include "asa/vision/ocr_engine_pool.h"
+#include "asa/vision/ocr_pipeline.h"
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+    constexpr size_t NUM_ROWS = 200;
+
+    std::filesystem::path get_tessdata()
+    {
+        const char* env = std::getenv("ASAPP_BENCH_TESSDATA");
+        return env ? env : "tessdata";
+    }
+
+    /**
+     * @brief Gets the preprocessed masks of 200 tribelog rows, the recorded rows are
+     * repeated if there are fewer of them.
+     */
+    const std::vector<cv::Mat>& get_row_masks()
+    {
+        static const std::vector<cv::Mat> masks = [] {
+            std::vector<cv::Mat> ret;
+            const auto rows = asa::bench::get_recorded_crops("tribelog_rows");
+            if (rows.empty()) { return ret; }
+
+            const auto pipeline = asa::vision::ocr_pipeline()
+                                  .isolate({192, 192, 192}, 120)
+                                  .crop_to_content()
+                                  .upscale(2)
+                                  .pad(8);
+            for (size_t i = 0; i < NUM_ROWS; i++) {
+                ret.push_back(pipeline.run(rows[i % rows.size()]));
+            }
+            return ret;
+        }();
+        return masks;
+    }
+
+    /**
+     * @brief Reads the rows on the library thread pool sharing a pool of the given
+     * amount of engines, with a single engine every read waits for the previous one
+     * like behind the old global OCR mutex.
+     */
+    void ocr_tribelog_rows(benchmark::State& state)
+    {
+        const auto& masks = get_row_masks();
+        if (masks.empty()) {
+            return state.SkipWithError("ASAPP_BENCH_RECORDING has no tribelog_rows.");
+        }
+
+        const auto num_engines = static_cast<size_t>(state.range(0));
+        asa::vision::ocr_engine_pool pool(get_tessdata(), "eng", num_engines);
+        pool.reserve(num_engines);
+
+        for (auto _: state) {
+            asa::get_thread_pool().parallel_for(0, masks.size(), [&](const size_t i) {
+                const auto engine = pool.acquire();
+                benchmark::DoNotOptimize(
+                    engine->recognize(masks[i], tesseract::PSM_SINGLE_BLOCK, ""));
+            });
+        }
+        state.SetItemsProcessed(state.iterations() * masks.size());
+    }
+}
+
+BENCHMARK(ocr_tribelog_rows)->Arg(1)->Arg(2)->Arg(4)->Arg(8)
+                            ->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,95 @@
+#include "bench.h"
+#include "asa/game/embedded.h"
+#include "asa/game/window.h"
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+    // the push notifications area of the hud and the thresholds it is checked with.
+    const cv::Rect NOTIFICATIONS{568, 0, 746, 1080};
+
+    struct notification
+    {
+        asa::asset_ref text;
+        float threshold;
+    };
+
+    const std::vector<notification> NOTIFICATION_TEXTS{
+        {asa::embedded::text::detected_enemy, 0.7f},
+        {asa::embedded::text::teleport_in, 0.7f},
+        {asa::embedded::text::return_time_remaining, 0.85f},
+        {asa::embedded::text::arena_available_in, 0.7f},
+        {asa::embedded::text::arena_time_remaining, 0.85f},
+    };
+
+    std::vector<asa::vision::prepared_template> prepare(const int levels)
+    {
+        std::vector<asa::vision::prepared_template> ret;
+        for (const auto& [text, threshold]: NOTIFICATION_TEXTS) {
+            ret.emplace_back(text, cv::Mat(), asa::vision::pyramid_options{levels});
+        }
+        return ret;
+    }
+
+    /**
+     * @brief Checks every notification text on every recorded frame, at full scale
+     * (0) or coarse-to-fine from the given level.
+     */
+    void locate_notifications(benchmark::State& state)
+    {
+        const auto& frames = asa::bench::get_recorded_frames();
+        if (frames.empty()) {
+            return state.SkipWithError("ASAPP_BENCH_RECORDING is not set.");
+        }
+
+        const auto templates = prepare(static_cast<int>(state.range(0)));
+        for (auto _: state) {
+            for (const cv::Mat& frame: frames) {
+                for (size_t i = 0; i < templates.size(); i++) {
+                    benchmark::DoNotOptimize(asa::locate(
+                        templates[i], frame(NOTIFICATIONS),
+                        NOTIFICATION_TEXTS[i].threshold));
+                }
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * frames.size() * templates.size());
+    }
+
+    /**
+     * @brief Counts the checks of the recorded frames whose result differs between
+     * coarse-to-fine and full scale matching, reported as the "mismatches" counter.
+     */
+    void pyramid_agreement(benchmark::State& state)
+    {
+        const auto& frames = asa::bench::get_recorded_frames();
+        if (frames.empty()) {
+            return state.SkipWithError("ASAPP_BENCH_RECORDING is not set.");
+        }
+
+        const auto full = prepare(0);
+        const auto pyramid = prepare(static_cast<int>(state.range(0)));
+        int found = 0;
+        int mismatches = 0;
+        for (auto _: state) {
+            found = 0;
+            mismatches = 0;
+            for (const cv::Mat& frame: frames) {
+                for (size_t i = 0; i < full.size(); i++) {
+                    const float threshold = NOTIFICATION_TEXTS[i].threshold;
+                    const auto expected = asa::locate(full[i], frame(NOTIFICATIONS),
+                                                      threshold);
+                    const auto actual = asa::locate(pyramid[i], frame(NOTIFICATIONS),
+                                                    threshold);
+                    found += expected.has_value();
+                    mismatches += expected != actual;
+                }
+            }
+        }
+        state.counters["found"] = found;
+        state.counters["mismatches"] = mismatches;
+    }
+}
+
+BENCHMARK(locate_notifications)->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMillisecond);
+BENCHMARK(pyramid_agreement)->Arg(1)->Arg(2)->Iterations(1);
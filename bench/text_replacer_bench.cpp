@@ -0,0 +1,92 @@
+#include "bench.h"
+#include "asa/utility.h"
+#include "asa/core/text_replacer.h"
+
+#include <fstream>
+#include <sstream>
+#include <benchmark/benchmark.h>
+
+namespace
+{
+    // the fixes applied to the tribelog rows in tribe_manager.cpp.
+    const asa::text_replacer::replacements_t TRIBELOG_FIXES{
+        {"\"\n", "- "}, {"\n", " "}, {"\"", "'"}, {"}", ")"}, {"{", "("},
+        {"- Lvb", "- Lvl"}, {"- iLvl", "- Lvl"}, {"- Lvi", "- Lvl"},
+        {"- LvI", "- Lvl"}, {" - Lv ", " - Lvl "}, {"- Lyl", "- Lvl"},
+        {"- vl ", "- Lvl "}, {"- Lyi", "- Lvl "}, {"Lvl1", "Lvl"},
+        {"kilied", "killed"}, {"kilted", "killed"}, {"kilfed", "killed"},
+        {"deatht", "death!"}, {"'t", "'!"}, {"'l", "'!"}, {"  ", " "},
+        {"(Pin Coded)!", "(Pin Coded)'"}, {"y'!", ")'!"}, {"Bedy", "Bed)"},
+        {"Pin Codedy", "Pin Coded)"}, {"Wallt", "Wall'!"}, {"!!", "!"}, {"((", "("},
+        {"))", ")"}, {"''", "'"}, {"Turret!", "Turret'!"},
+        {"(Pin Coded) ", "(Pin Coded)'"}
+    };
+
+    // rows in the shape tesseract returns them, with the mistakes the fixes target.
+    const std::vector<std::string> SYNTHETIC_ROWS{
+        "Your \"Rex - Lvb 150 (Rex)\" was kilied by \"Giga - Lyl 210 (Giga)\"!",
+        "Your Tribe killed \"Raptor - LvI 30 {Raptor}\"\n",
+        "Your \"Metal Wall\" was destroyed!  ",
+        "Human demolished a \"Wooden Bed\n(Pin Coded)\"!",
+        "Your 'Stego - Lv 45 (Stegosaurus)'t was kilted by a Sabertooth - Lvi 20!",
+        "Tribemember Human - Lvl1 105 was kilfed by an Alpha Carno - Lvl 90!!",
+        "Human claimed 'Argentavis - iLvl 224 (Argentavis)'l",
+        "Your Tribe Tamed a Parasaur - Lyi 127 (Parasaur)!",
+        "Human uploaded a Pteranodon: Ptera - Lvl 190 (Pteranodon)",
+        "Your \"Heavy Auto Turret\" was destroyed!",
+    };
+
+    /**
+     * @brief Gets the raw OCR strings of tribelog rows, one per text file in the
+     * "tribelog_text" directory of the recording, or the synthetic rows without one.
+     */
+    const std::vector<std::string>& get_rows()
+    {
+        static const std::vector<std::string> rows = [] {
+            std::vector<std::string> ret;
+            const std::filesystem::path dir = asa::bench::get_recording() /
+                                              "tribelog_text";
+            if (!asa::bench::get_recording().empty() &&
+                std::filesystem::is_directory(dir)) {
+                for (const auto& entry: std::filesystem::directory_iterator(dir)) {
+                    if (entry.path().extension() != ".txt") { continue; }
+                    std::ifstream file(entry.path(), std::ios::binary);
+                    std::stringstream ss;
+                    ss << file.rdbuf();
+                    ret.push_back(ss.str());
+                }
+            }
+            return ret.empty() ? SYNTHETIC_ROWS : ret;
+        }();
+        return rows;
+    }
+
+    /**
+     * @brief The fixes as they were applied before, a find and replace loop per fix.
+     */
+    void fix_map(benchmark::State& state)
+    {
+        const std::map<std::string, std::string> fixes(TRIBELOG_FIXES.begin(),
+                                                       TRIBELOG_FIXES.end());
+        for (auto _: state) {
+            for (const std::string& row: get_rows()) {
+                benchmark::DoNotOptimize(asa::fix(row, fixes));
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * get_rows().size());
+    }
+
+    void fix_replacer(benchmark::State& state)
+    {
+        const asa::text_replacer fixes(TRIBELOG_FIXES);
+        for (auto _: state) {
+            for (const std::string& row: get_rows()) {
+                benchmark::DoNotOptimize(asa::fix(row, fixes));
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * get_rows().size());
+    }
+}
+
+BENCHMARK(fix_map)->Unit(benchmark::kMicrosecond);
+BENCHMARK(fix_replacer)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,123 @@
+#include "bench.h"
+#include "asa/vision/color_count.h"
+
+#include <benchmark/benchmark.h>
+#include <opencv2/core.hpp>
+
+namespace
+{
+    // the event colors of tribe_manager.cpp in the order they are checked.
+    const std::vector<cv::Vec3b> EVENT_COLORS{
+        {255, 0, 255}, {230, 233, 8}, {255, 0, 0}, {252, 223, 148}, {0, 255, 0},
+        {192, 192, 192}, {251, 168, 1}, {255, 255, 255}, {0, 0, 255}, {0, 252, 252},
+        {237, 108, 137}, {176, 234, 194}
+    };
+    constexpr int EVENT_COLOR_TOLERANCE = 40;
+    constexpr int MIN_EVENT_PIXELS = 250;
+
+    const cv::Size ROW_SIZE{350, 20};
+
+    const std::vector<asa::vision::color_range>& get_ranges()
+    {
+        static const std::vector<asa::vision::color_range> ranges = [] {
+            std::vector<asa::vision::color_range> ret;
+            for (const cv::Vec3b& color: EVENT_COLORS) {
+                ret.push_back(asa::vision::color_range::of(color,
+                                                           EVENT_COLOR_TOLERANCE));
+            }
+            return ret;
+        }();
+        return ranges;
+    }
+
+    /**
+     * @brief Gets the saved crops of tribelog rows in the "tribelog_rows" directory of
+     * the recording, or synthetic rows with text in each event color without one.
+     */
+    const std::vector<cv::Mat>& get_rows()
+    {
+        static const std::vector<cv::Mat> rows = [] {
+            auto ret = asa::bench::get_recorded_crops("tribelog_rows");
+            if (!ret.empty()) { return ret; }
+
+            for (size_t i = 0; i < EVENT_COLORS.size(); i++) {
+                cv::Mat row = asa::bench::make_synthetic_frame({}, ROW_SIZE);
+                for (int x = 120; x < 330; x += 7) {
+                    row(cv::Rect(x, 5, 4, 10)).setTo(cv::Scalar(EVENT_COLORS[i]));
+                }
+                ret.push_back(std::move(row));
+            }
+            return ret;
+        }();
+        return rows;
+    }
+
+    int pick(const std::vector<int>& counts)
+    {
+        for (size_t i = 0; i < counts.size(); i++) {
+            if (counts[i] > MIN_EVENT_PIXELS) { return static_cast<int>(i); }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief The classification before, a mask and count per color until one matches.
+     */
+    int classify_opencv(const cv::Mat& row)
+    {
+        cv::Mat mask;
+        for (size_t i = 0; i < get_ranges().size(); i++) {
+            cv::inRange(row, get_ranges()[i].low, get_ranges()[i].high, mask);
+            if (cv::countNonZero(mask) > MIN_EVENT_PIXELS) { return static_cast<int>(i); }
+        }
+        return -1;
+    }
+
+    int classify_fused(const cv::Mat& row)
+    {
+        std::vector<int> counts(get_ranges().size());
+        asa::vision::count_each_in_ranges(row, get_ranges(), counts);
+        return pick(counts);
+    }
+
+    void classify_rows_opencv(benchmark::State& state)
+    {
+        for (auto _: state) {
+            for (const cv::Mat& row: get_rows()) {
+                benchmark::DoNotOptimize(classify_opencv(row));
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * get_rows().size());
+    }
+
+    void classify_rows_fused(benchmark::State& state)
+    {
+        for (auto _: state) {
+            for (const cv::Mat& row: get_rows()) {
+                benchmark::DoNotOptimize(classify_fused(row));
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * get_rows().size());
+    }
+
+    /**
+     * @brief Counts the rows that are classified differently by both, reported as the
+     * "mismatches" counter next to the amount of rows.
+     */
+    void classify_rows_agreement(benchmark::State& state)
+    {
+        int mismatches = 0;
+        for (auto _: state) {
+            mismatches = 0;
+            for (const cv::Mat& row: get_rows()) {
+                mismatches += classify_opencv(row) != classify_fused(row);
+            }
+        }
+        state.counters["rows"] = static_cast<double>(get_rows().size());
+        state.counters["mismatches"] = mismatches;
+    }
+}
+
+BENCHMARK(classify_rows_opencv)->Unit(benchmark::kMicrosecond);
+BENCHMARK(classify_rows_fused)->Unit(benchmark::kMicrosecond);
+BENCHMARK(classify_rows_agreement)->Iterations(1);
@@ -1,35 +1,142 @@
 from io import TextIOWrapper
 import json
 import pathlib
+import struct
 import cv2
+import numpy
 
 output_file = "include/asa/game/embedded.h"
+output_pack = "assets.pack"
 assets = pathlib.Path("assets")
 
+MAGIC = b"ASAPACK\x01"
+ENTRY_SIZE = 32
+BLOB_ALIGNMENT = 16
+
+ENCODING_RAW = 0
+ENCODING_PNG = 1
+ENCODING_DATA = 2
+
+# How much smaller than the raw pixels a PNG has to be to be worth decoding.
+PNG_RATIO = 0.5
+
+CV_8U = 0
+
+# The entries of the pack: name, encoding, rows, cols, mat type and the blob.
+pack: list[tuple[str, int, int, int, int, bytes]] = []
+
+# Whether the icon of each item was exported from the game files, by file stem.
+exported_icons: dict[str, bool] = {}
+
+# The scales of the item icons for 1920x1080, exported icons are 256x256.
+SCALE_INV = 0.24
+SCALE_NOTIF = 0.44
+SCALE_NOTIF_EXPORT = 0.11
+
+
+def pack_image(name: str, image: numpy.ndarray, compress: bool = True):
+    """Adds an image to the pack, PNG compressed if that makes it considerably smaller."""
+    image = numpy.ascontiguousarray(image, "uint8")
+    height, width = image.shape[:2]
+    channels: int = 1 if image.ndim == 2 else image.shape[2]
+    mat_type = CV_8U + (channels - 1) * 8
+
+    raw = image.tobytes()
+    if compress:
+        png = cv2.imencode(".png", image)[1].tobytes()
+        if len(png) < len(raw) * PNG_RATIO:
+            pack.append((name, ENCODING_PNG, height, width, mat_type, png))
+            return
+    pack.append((name, ENCODING_RAW, height, width, mat_type, raw))
+
+
+def pack_data(name: str, data: bytes):
+    pack.append((name, ENCODING_DATA, 0, 0, 0, data))
+
+
+def write_pack():
+    """
+    Writes the pack, all numbers are little endian.
+
+    header: 8 byte magic, u32 amount of entries, 4 reserved bytes
+    entry:  u64 blob offset, u64 blob size, i32 rows, i32 cols, i32 mat type,
+            u8 encoding, u8 reserved, u16 name length, the name (utf-8)
+    blobs:  each starting at a multiple of BLOB_ALIGNMENT
+    """
+    names = [name.encode() for name, *_ in pack]
+    offset = 16 + sum(ENTRY_SIZE + len(name) for name in names)
+
+    index = bytearray(MAGIC + struct.pack("<II", len(pack), 0))
+    blobs = bytearray()
+    for name, (_, encoding, rows, cols, mat_type, blob) in zip(names, pack):
+        padding = -(offset + len(blobs)) % BLOB_ALIGNMENT
+        blobs += bytes(padding)
+
+        index += struct.pack(
+            "<QQiiiBBH",
+            offset + len(blobs),
+            len(blob),
+            rows,
+            cols,
+            mat_type,
+            encoding,
+            0,
+            len(name),
+        )
+        index += name
+        blobs += blob
+
+    with open(output_pack, "wb") as f:
+        f.write(index)
+        f.write(blobs)
+
+
+def scale(image: numpy.ndarray, factor: float) -> numpy.ndarray:
+    # the size is computed in float precision like the C++ code always did, so the
+    # icons come out exactly the same size.
+    width = int(numpy.float32(image.shape[1]) * numpy.float32(factor))
+    height = int(numpy.float32(image.shape[0]) * numpy.float32(factor))
+    return cv2.resize(image, (width, height), interpolation=cv2.INTER_LINEAR)
+
+
+def alpha_mask(image: numpy.ndarray) -> numpy.ndarray:
+    # the visible pixels of the icon, every pixel if it has no transparency.
+    if image.ndim != 3 or image.shape[2] != 4 or not (image[:, :, 3] > 0).any():
+        return numpy.ones(image.shape[:2], "uint8")
+    return (image[:, :, 3] > 0).astype("uint8") * 255
+
+
+def conv_item_icon(file: pathlib.Path):
+    """Packs the inventory and notification icons of an item and their masks."""
+    icon = cv2.imread(str(file), cv2.IMREAD_UNCHANGED)
+
+    # Icons exported from the game files (such as the devkit) are 256x256 and have
+    # to be scaled down for the inventory, the ones we cropped ourselves are not.
+    exported = icon.shape[0] == 256 and icon.shape[1] == 256
+    inventory = scale(icon, SCALE_INV) if exported else icon
+    notification = scale(icon, SCALE_NOTIF_EXPORT if exported else SCALE_NOTIF)
+
+    # every item icon is needed once the items are loaded, so they are kept raw to
+    # not have to decode hundreds of them at startup.
+    name = f"items/{file.stem}"
+    pack_image(f"{name}_inventory", inventory[:, :, :3], False)
+    pack_image(f"{name}_inventory_mask", alpha_mask(inventory), False)
+    pack_image(f"{name}_notification", notification[:, :, :3], False)
+    pack_image(f"{name}_notification_mask", alpha_mask(notification), False)
+    exported_icons[file.stem] = exported
+
 
 def conv_files(folder: pathlib.Path, stream: TextIOWrapper):
     for file in folder.iterdir():
         if ".ico" in file.name:
             continue
-        stream.write(f"inline constexpr uint8_t {file.stem}_data[] = {{\n")
 
-        if folder.parent.stem != "items":
-            image = cv2.imread(str(file))
+        if folder.parent.stem == "items":
+            conv_item_icon(file)
         else:
-            image = cv2.imread(str(file), cv2.IMREAD_UNCHANGED)
-
-        height, width, _ = image.shape
-        image_data = image.flatten().astype("uint8")
-
-        for byte in image_data:
-            stream.write(f"0x{byte:02X}, ")
-
-        stream.write("\n};\n")
-
-        channels: int = 4 if folder.parent.stem == "items" else 3
-        stream.write(
-            f"inline const cv::Mat {file.stem} = cv::Mat({height}, {width}, CV_8UC{channels}, (uchar*){file.stem}_data);\n"
-        )
+            name = f"{folder.name}/{file.stem}"
+            pack_image(name, cv2.imread(str(file)))
+            stream.write(f'inline constexpr asset_ref {file.stem}{{"{name}"}};\n')
 
 
 def run():
@@ -37,56 +144,34 @@ def run():
         f.write("// Automatically generated\n")
 
         f.write("#pragma once\n")
-        f.write("#include <opencv2/opencv.hpp>\n")
-        f.write("#include <map>\n")
-        f.write("#include <cstdint>\n\n")
+        f.write('#include "asa/game/asset_pack.h"\n\n')
 
         f.write(f"namespace asa::embedded {{\n")
 
         for folder in assets.iterdir():
             print(folder)
 
-            f.write(f"namespace {folder.name} {{\n")
             if folder.name == "items":
                 for sub in folder.iterdir():
                     conv_files(sub, f)
-            else:
-                conv_files(folder, f)
-
-            f.write("\n}\n")
+                continue
 
-        with open("itemdata.json", "r") as itemdata:
-            json_data: dict[str, dict] = json.load(itemdata)
-
-        json_string = json.dumps(json_data).strip()
-
-        # Split into chunks
-        chunk_size = 1024  # Adjust the size to suit your needs
-        chunks = [
-            json_string[i : i + chunk_size]
-            for i in range(0, len(json_string), chunk_size)
-        ]
-
-        # Write the C++ code
-        f.write("inline const char* embedded_json = ")
-        for chunk in chunks:
-            f.write(f'R"({chunk})"\n')
-        f.write(";")
-
-        # f.write(f'const char* embedded_json = R"({json.dumps(json_data).strip()})";\n')
-
-        f.write("inline std::map<std::string, cv::Mat> item_icon_map = {")
+            f.write(f"namespace {folder.name} {{\n")
+            conv_files(folder, f)
+            f.write("}\n")
 
-        for k, v in json_data.items():
-            path = v["icon"][:-4]
-            split = path.split("\\")
-            path = f"items::{split[-1]}"
+        f.write("}\n")
 
-            f.write("{" + f'"{k}", {path}' + "},")
+    with open("itemdata.json", "r") as itemdata:
+        json_data: dict[str, dict] = json.load(itemdata)
 
-        f.write("\n};")
+    # whether the icon was exported decides how it was scaled, so it is only known now.
+    for data in json_data.values():
+        stem = pathlib.PureWindowsPath(data["icon"]).stem
+        data["icon_exported"] = exported_icons.get(stem, False)
 
-        f.write("\n}\n")
+    pack_data("itemdata.json", json.dumps(json_data).encode())
+    write_pack()
 
 
 run()
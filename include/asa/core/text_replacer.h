@@ -0,0 +1,71 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace asa
+{
+    /**
+     * @brief Replaces many substrings of a text in a single left to right pass.
+     *
+     * The patterns are compiled into an Aho-Corasick automaton once, replacing then
+     * costs one pass over the text no matter how many patterns there are. Where
+     * matches overlap, the match that starts first wins and of those the longest,
+     * the text after a replaced match is searched again from the end of the match.
+     */
+    class text_replacer
+    {
+    public:
+        using replacements_t = std::vector<std::pair<std::string, std::string> >;
+
+        /**
+         * @brief Compiles the replacements.
+         *
+         * @param t_replacements The patterns and what to replace them with, empty
+         * patterns are ignored and of duplicate patterns the last one is used.
+         */
+        explicit text_replacer(const replacements_t& t_replacements);
+
+        text_replacer(std::initializer_list<replacements_t::value_type> t_replacements)
+            : text_replacer(replacements_t(t_replacements)) {}
+
+        /**
+         * @brief Replaces all (non overlapping) matches of the patterns in a text.
+         *
+         * @param text The text to replace the matches in.
+         * @param replaced Set to the amount of matches that were replaced, if given.
+         *
+         * @return The text with all matches replaced.
+         */
+        [[nodiscard]] std::string replace(std::string_view text,
+                                          size_t* replaced = nullptr) const;
+
+    private:
+        struct output
+        {
+            // the length of the longest pattern that ends at a state, 0 if none.
+            size_t length = 0;
+            size_t replacement = 0;
+        };
+
+        [[nodiscard]] int32_t next(int32_t state, char c) const
+        {
+            return transitions_[state * num_classes_ + classes_[static_cast<uint8_t>(c)]];
+        }
+
+        // bytes that dont occur in any pattern share class 0.
+        std::array<uint16_t, 256> classes_{};
+        size_t num_classes_ = 1;
+
+        // the full transition table, num_classes_ entries per state.
+        std::vector<int32_t> transitions_;
+        std::vector<size_t> depths_;
+        std::vector<output> outputs_;
+
+        std::vector<std::string> replacements_;
+    };
+}
@@ -0,0 +1,138 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace asa
+{
+    /**
+     * @brief The priority of a task, higher priority tasks are always run first.
+     */
+    enum class TaskPriority : int32_t
+    {
+        LOW,
+        NORMAL,
+        HIGH,
+    };
+
+    /**
+     * @brief A fixed set of worker threads that run submitted tasks.
+     *
+     * Every worker has its own queue that it takes tasks from, a worker that runs out
+     * of tasks steals from the queues of the other workers. Tasks submitted by a worker
+     * go to its own queue, other tasks are spread over the queues.
+     *
+     * @remark A task must not block on the future of another task, the pool is not
+     * guaranteed to have a free worker to run it. Use `parallel_for` for nested work.
+     */
+    class thread_pool
+    {
+    public:
+        /**
+         * @brief Creates the pool and starts its workers.
+         *
+         * @param t_num_threads The amount of worker threads, at least 1.
+         */
+        explicit thread_pool(size_t t_num_threads = std::thread::hardware_concurrency());
+
+        /**
+         * @brief Runs all queued tasks and joins the workers.
+         */
+        ~thread_pool();
+
+        thread_pool(const thread_pool&) = delete;
+
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        /**
+         * @brief Submits a task to be run by one of the workers.
+         *
+         * @param fn The task to run.
+         * @param priority The priority of the task.
+         *
+         * @return A future for the result of the task, exceptions thrown by the task
+         * are rethrown from it.
+         */
+        template<typename Fn>
+        auto submit(Fn&& fn, const TaskPriority priority = TaskPriority::NORMAL)
+            -> std::future<std::invoke_result_t<std::decay_t<Fn> > >
+        {
+            using result_t = std::invoke_result_t<std::decay_t<Fn> >;
+
+            std::packaged_task<result_t()> task(std::forward<Fn>(fn));
+            std::future<result_t> future = task.get_future();
+            push(std::move(task), priority);
+            return future;
+        }
+
+        /**
+         * @brief Submits a task whose result is not needed to be run by one of the
+         * workers, anything thrown by the task is logged.
+         *
+         * @param fn The task to run.
+         * @param priority The priority of the task.
+         */
+        void post(std::function<void()> fn, TaskPriority priority = TaskPriority::NORMAL);
+
+        /**
+         * @brief Runs a function for every index within [begin, end) on the workers.
+         *
+         * The calling thread works on the indices as well, so this may be called from
+         * a task of the pool without risking a deadlock.
+         *
+         * @param begin The first index.
+         * @param end The index past the last index.
+         * @param fn The function to call with every index.
+         * @param priority The priority of the work given to the workers.
+         * @param max_threads The maximum amount of threads working on the indices,
+         * including the calling thread, 0 for no limit.
+         *
+         * @throws The first exception thrown by any call of the function, once all
+         * indices that were started have finished.
+         */
+        void parallel_for(size_t begin, size_t end,
+                          const std::function<void(size_t)>& fn,
+                          TaskPriority priority = TaskPriority::NORMAL,
+                          size_t max_threads = 0);
+
+        [[nodiscard]] size_t get_num_threads() const { return threads_.size(); }
+
+    private:
+        using task_t = std::move_only_function<void()>;
+
+        static constexpr size_t NUM_PRIORITIES = 3;
+
+        struct worker_queue
+        {
+            std::mutex mutex;
+            std::deque<task_t> tasks[NUM_PRIORITIES];
+        };
+
+        void push(task_t task, TaskPriority priority);
+
+        bool try_pop(size_t worker, task_t& out);
+
+        void run(size_t worker);
+
+        std::vector<std::unique_ptr<worker_queue> > queues_;
+        std::vector<std::thread> threads_;
+
+        // the amount of queued tasks, workers sleep while there are none.
+        std::atomic<size_t> queued_{0};
+        std::atomic<size_t> next_queue_{0};
+        std::atomic<bool> stopping_{false};
+        std::mutex wake_mutex_;
+        std::condition_variable wake_;
+    };
+
+    /**
+     * @brief Gets the thread pool shared by the library, sized to the hardware threads.
+     */
+    [[nodiscard]] thread_pool& get_thread_pool();
+}
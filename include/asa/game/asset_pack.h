@@ -0,0 +1,144 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <opencv2/core.hpp>
+
+namespace asa
+{
+    /**
+     * @brief A read-only pack of all assets, memory mapped from a single file.
+     *
+     * The pack starts with a header and an index of the names of its assets, followed
+     * by the blobs of the assets. A blob is either the raw pixels of an image, a PNG
+     * compressed image or arbitrary data such as the item data json.
+     *
+     * Images are only decoded when they are requested for the first time, raw images
+     * are not copied at all but refer to the mapped file directly.
+     *
+     * @remark The pack is written by embed.py, see there for the exact layout.
+     * @remark The mats handed out are shared by every user of the asset, they must be
+     * cloned before writing to them. The file is mapped copy on write, so a write
+     * can not change the file but is seen by every other user.
+     */
+    class asset_pack
+    {
+    public:
+        /**
+         * @brief Maps a pack file and reads its index.
+         *
+         * @param t_path The path of the pack file.
+         *
+         * @throws asset_pack_error If the file could not be mapped or is not a pack.
+         */
+        explicit asset_pack(std::filesystem::path t_path);
+
+        ~asset_pack();
+
+        asset_pack(const asset_pack&) = delete;
+
+        asset_pack& operator=(const asset_pack&) = delete;
+
+        /**
+         * @brief Gets an image of the pack, decoding it if it was not requested yet.
+         *
+         * @param name The name of the image, e.g. "text/resume".
+         *
+         * @throws asset_not_found If the pack has no image of that name.
+         */
+        [[nodiscard]] const cv::Mat& get(std::string_view name) const;
+
+        /**
+         * @brief Gets the data of a data asset of the pack.
+         *
+         * @param name The name of the asset, e.g. "itemdata.json".
+         *
+         * @throws asset_not_found If the pack has no data asset of that name.
+         */
+        [[nodiscard]] std::string_view get_data(std::string_view name) const;
+
+        [[nodiscard]] bool contains(std::string_view name) const;
+
+        [[nodiscard]] size_t size() const { return entries_.size(); }
+
+        [[nodiscard]] const std::filesystem::path& get_path() const { return path_; }
+
+    private:
+        enum blob_encoding : uint8_t
+        {
+            RAW = 0,
+            PNG = 1,
+            DATA = 2,
+        };
+
+        struct entry
+        {
+            blob_encoding encoding = RAW;
+            int rows = 0;
+            int cols = 0;
+            int type = 0;
+            const uint8_t* data = nullptr;
+            size_t size = 0;
+
+            // the decoded image, set the first time the image is requested.
+            mutable std::once_flag decoded;
+            mutable cv::Mat mat;
+        };
+
+        void map_file();
+
+        void unmap_file();
+
+        void read_index();
+
+        [[nodiscard]] const entry& find(std::string_view name) const;
+
+        std::filesystem::path path_;
+        const uint8_t* data_ = nullptr;
+        size_t size_ = 0;
+
+        // the handles of the mapping, only used on windows.
+        void* file_ = nullptr;
+        void* mapping_ = nullptr;
+
+        std::map<std::string, entry, std::less<> > entries_;
+    };
+
+    /**
+     * @brief Sets the path of the pack to open when the first asset is requested,
+     * by default "assets.pack" next to the executable.
+     *
+     * @remark Has no effect once the pack was opened.
+     */
+    void set_asset_pack_path(std::filesystem::path path);
+
+    /**
+     * @brief Gets the asset pack, opening it on the first call.
+     */
+    [[nodiscard]] const asset_pack& get_asset_pack();
+
+    /**
+     * @brief Gets an image of the asset pack, see `asset_pack::get`.
+     *
+     * @remark The image is shared, clone it before writing to it.
+     */
+    [[nodiscard]] const cv::Mat& asset(std::string_view name);
+
+    /**
+     * @brief Refers to an image of the asset pack by name.
+     *
+     * Converts to the image implicitly, so it can be passed wherever the image itself
+     * is expected. Being a constant, it costs nothing until the image is requested.
+     */
+    struct asset_ref
+    {
+        std::string_view name;
+
+        [[nodiscard]] const cv::Mat& get() const { return asset(name); }
+
+        operator const cv::Mat&() const { return asset(name); }
+    };
+}
@@ -0,0 +1,145 @@
+#pragma once
+#include "asa/game/frame.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace asa
+{
+    /**
+     * @brief Captures frames on a dedicated thread at a fixed rate and keeps the most
+     * recent ones in a fixed-size ring buffer.
+     *
+     * While the service is running, consumers read the latest frame instead of paying
+     * for a capture on their own thread, and may look back at recent frames, e.g. to
+     * detect blinking icons without having to wait for another blink.
+     *
+     * @remark The ring is a fixed array of slots guarded by sequence numbers and reader
+     * counts rather than a mutex, reading frames never blocks and publishing only
+     * waits for readers that are copying the frame out of the slot it replaces. Only
+     * `wait_newer` blocks until the capture thread signals a new frame.
+     */
+    class capture_service
+    {
+    public:
+        /**
+         * @brief Creates a (stopped) capture service.
+         *
+         * @param t_capacity The amount of recent frames to keep, each frame is ~6MB.
+         */
+        explicit capture_service(size_t t_capacity = 16);
+
+        ~capture_service();
+
+        capture_service(const capture_service&) = delete;
+
+        capture_service& operator=(const capture_service&) = delete;
+
+        /**
+         * @brief Starts capturing frames on the capture thread.
+         *
+         * @param interval The time between the start of two captures.
+         *
+         * @remark Does nothing if the service is already running.
+         */
+        void start(std::chrono::milliseconds interval = 50ms);
+
+        /**
+         * @brief Stops capturing and joins the capture thread.
+         */
+        void stop();
+
+        /**
+         * @brief Checks whether the capture thread is running.
+         */
+        [[nodiscard]] bool is_running() const { return running_; }
+
+        /**
+         * @brief Gets the interval the service was last started with.
+         */
+        [[nodiscard]] std::chrono::milliseconds get_interval() const { return interval_; }
+
+        /**
+         * @brief Gets the most recently captured frame, nullptr if none is available.
+         */
+        [[nodiscard]] frame_ptr latest() const;
+
+        /**
+         * @brief Waits for a frame newer than the given sequence number.
+         *
+         * @param sequence The sequence of the last frame that the caller has seen.
+         * @param timeout The maximum time to wait for a newer frame.
+         *
+         * @return The newest frame if it is newer than the sequence, else nullptr.
+         */
+        [[nodiscard]] frame_ptr wait_newer(uint64_t sequence,
+                                           std::chrono::milliseconds timeout = 1s) const;
+
+        /**
+         * @brief Gets all buffered frames that are at most the given age old.
+         *
+         * @param max_age The maximum age of the frames to get.
+         *
+         * @return The frames sorted from the newest to the oldest frame.
+         */
+        [[nodiscard]] std::vector<frame_ptr> history(
+            std::chrono::milliseconds max_age) const;
+
+    private:
+        struct slot
+        {
+            // the publish index + 1 of the frame in the slot, 0 if the slot is empty
+            // and WRITING while the frame of the slot is being replaced.
+            std::atomic<uint64_t> sequence{0};
+            // the amount of readers that are copying the frame out of the slot.
+            std::atomic<uint32_t> readers{0};
+            frame_ptr frame;
+        };
+
+        static constexpr uint64_t WRITING = UINT64_MAX;
+
+        void run();
+
+        void publish(frame_ptr frame);
+
+        /**
+         * @brief Reads the frame that was published at an index.
+         *
+         * @return The frame, nullptr if the slot holds a different frame by now.
+         */
+        [[nodiscard]] frame_ptr read(uint64_t index) const;
+
+        size_t capacity_;
+        std::unique_ptr<slot[]> ring_;
+
+        // the amount of frames published so far, the next frame goes to head_ % capacity
+        std::atomic<uint64_t> head_{0};
+
+        std::atomic<bool> running_{false};
+        std::chrono::milliseconds interval_{50ms};
+        std::thread thread_;
+
+        mutable std::mutex signal_mutex_;
+        mutable std::condition_variable signal_;
+    };
+
+    /**
+     * @brief Gets the capture service shared by the library, stopped until started.
+     */
+    [[nodiscard]] capture_service* get_capture_service();
+
+    /**
+     * @brief Gets a frame newer than the given sequence for polling loops.
+     *
+     * @param sequence The sequence of the last frame the caller has looked at.
+     *
+     * @return The next frame of the capture service if it's running, otherwise a new
+     * capture of the window.
+     */
+    [[nodiscard]] frame_ptr get_next_frame(uint64_t sequence);
+}
@@ -35,4 +35,19 @@ namespace asa
                 "Could not initialize tesseract with tessdata path '{}'!",
                 t_tessdata_path.string())) {}
     };
+
+    struct asset_pack_error final : asapp_error
+    {
+    public:
+        asset_pack_error(const std::filesystem::path& t_path, const std::string& t_reason)
+            : asapp_error(std::format("Could not load asset pack '{}': {}!",
+                                      t_path.string(), t_reason)) {}
+    };
+
+    struct asset_not_found final : asapp_error
+    {
+    public:
+        explicit asset_not_found(const std::string_view t_name)
+            : asapp_error(std::format("Asset '{}' is not in the asset pack!", t_name)) {}
+    };
 }
@@ -0,0 +1,125 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <opencv2/core.hpp>
+
+using namespace std::chrono_literals;
+
+namespace asa
+{
+    /**
+     * @brief An immutable capture of the full game window.
+     *
+     * A frame is captured once and may then be shared by any amount of predicates,
+     * allowing a whole decision pass (e.g. checking all 36 inventory slots) to cost
+     * a single capture instead of one capture per region.
+     */
+    struct frame
+    {
+    public:
+        frame(uint64_t t_sequence, cv::Mat t_image);
+
+        /**
+         * @brief Gets the time that has passed since the frame was captured.
+         */
+        [[nodiscard]] std::chrono::milliseconds age() const;
+
+        /**
+         * @brief Checks whether the frame is not older than the given age.
+         *
+         * @param max_age The maximum age the frame may have to be considered fresh.
+         */
+        [[nodiscard]] bool is_fresh(std::chrono::milliseconds max_age) const;
+
+        /**
+         * @brief Gets a view of a region of the frame, no pixel data is copied.
+         *
+         * @param region The region of the frame to get, clamped to the frame bounds.
+         *
+         * @remark The returned mat shares memory with the frame and must not be written.
+         */
+        [[nodiscard]] cv::Mat crop(const cv::Rect& region) const;
+
+        /**
+         * @brief A monotonic number identifying the capture, later frames are higher.
+         */
+        const uint64_t sequence;
+
+        const std::chrono::steady_clock::time_point captured_at;
+
+        const cv::Mat image;
+    };
+
+    using frame_ptr = std::shared_ptr<const frame>;
+
+    /**
+     * @brief Captures a new frame of the game window, regardless of any cached frame.
+     *
+     * @return A shared pointer to the captured frame, also stored as the last frame.
+     */
+    [[nodiscard]] frame_ptr capture_frame();
+
+    /**
+     * @brief Gets a frame that is at most the given age old.
+     *
+     * @param max_age The maximum age of the frame, 0ms to always capture a new frame.
+     *
+     * @return The last captured frame if it is fresh enough, a new frame otherwise.
+     */
+    [[nodiscard]] frame_ptr get_frame(std::chrono::milliseconds max_age = 0ms);
+
+    /**
+     * @brief Gets the most recently captured frame, may be nullptr.
+     */
+    [[nodiscard]] frame_ptr get_last_frame();
+
+    /**
+     * @brief Gets the frame pinned on the calling thread by a frame_scope, if any.
+     */
+    [[nodiscard]] frame_ptr get_scoped_frame();
+
+    /**
+     * @brief Pins a frame on the current thread for the lifetime of the scope.
+     *
+     * While a scope is alive every `screenshot(region)` based call on this thread
+     * (`match`, `locate`, `utility::mask`, `utility::count_matches`...) reads from the
+     * pinned frame rather than capturing the window again.
+     *
+     * @remark Scopes may be nested, the previous frame is restored on destruction.
+     * @remark Never hold a scope across an input that must be observed on screen.
+     */
+    class frame_scope
+    {
+    public:
+        /**
+         * @brief Pins a frame that is at most the given age old.
+         *
+         * @param max_age The maximum age of the frame to pin.
+         *
+         * @remark If a frame is already pinned by an outer scope it is kept, the outer
+         * decision pass is responsible for the freshness of its frame.
+         */
+        explicit frame_scope(std::chrono::milliseconds max_age = 0ms);
+
+        /**
+         * @brief Pins the given frame, nullptr to temporarily capture live again.
+         */
+        explicit frame_scope(frame_ptr t_frame);
+
+        ~frame_scope();
+
+        frame_scope(const frame_scope&) = delete;
+
+        frame_scope& operator=(const frame_scope&) = delete;
+
+        /**
+         * @brief Gets the frame pinned by this scope.
+         */
+        [[nodiscard]] const frame_ptr& get() const { return frame_; }
+
+    private:
+        frame_ptr frame_;
+        frame_ptr previous_;
+    };
+}
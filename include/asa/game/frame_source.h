@@ -0,0 +1,158 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+
+namespace asa
+{
+    /**
+     * @brief A source of images of the game window that all captures are served from.
+     *
+     * The library captures the live game window through GDI by default, other sources
+     * may be installed with `set_frame_source` to run the vision code on recordings.
+     *
+     * @remark Images are always 1920x1080 BGR, the same as a capture of the game window.
+     */
+    class frame_source
+    {
+    public:
+        virtual ~frame_source() = default;
+
+        /**
+         * @brief Grabs a region of the current image of the source.
+         *
+         * @param region The region of the image to grab.
+         *
+         * @return A cv::Mat owning the grabbed region.
+         */
+        [[nodiscard]] virtual cv::Mat grab(const cv::Rect& region) = 0;
+
+        /**
+         * @brief Gets the color of a single pixel of the current image in RGB format.
+         */
+        [[nodiscard]] virtual cv::Vec3b pixel(const cv::Point& point);
+
+        /**
+         * @brief Checks whether the source is currently able to provide images.
+         */
+        [[nodiscard]] virtual bool is_available() const = 0;
+    };
+
+    /**
+     * @brief Captures the live game window using PrintWindow (or BitBlt if the window
+     * is not 1920x1080), the default frame source.
+     */
+    class gdi_frame_source final : public frame_source
+    {
+    public:
+        [[nodiscard]] cv::Mat grab(const cv::Rect& region) override;
+
+        [[nodiscard]] cv::Vec3b pixel(const cv::Point& point) override;
+
+        [[nodiscard]] bool is_available() const override;
+    };
+
+    /**
+     * @brief Replays a recorded session from a directory of images or a video file.
+     *
+     * The position in the recording advances with the time passed since the replay was
+     * started multiplied by the playback speed, or only when `step` is called if the
+     * speed is 0, which allows benchmarking every frame as fast as possible.
+     */
+    class replay_frame_source final : public frame_source
+    {
+    public:
+        /**
+         * @brief Creates a replay from a recording.
+         *
+         * @param t_path A directory of images (played in name order) or a video file.
+         * @param t_speed The playback speed, 1 for real time, 0 for manual stepping.
+         * @param t_fps The framerate of an image directory, videos use their own.
+         * @param t_loop Whether to start over once the end has been reached.
+         *
+         * @throws asapp_error If the recording could not be opened or is empty.
+         */
+        explicit replay_frame_source(std::filesystem::path t_path, float t_speed = 1.f,
+                                     double t_fps = 30., bool t_loop = false);
+
+        [[nodiscard]] cv::Mat grab(const cv::Rect& region) override;
+
+        /**
+         * @brief Checks whether the replay has not moved past its last frame yet,
+         * always true if it loops.
+         */
+        [[nodiscard]] bool is_available() const override;
+
+        /**
+         * @brief Advances the replay by one frame.
+         *
+         * @return False if the replay moved past the last frame, true if there is a
+         * frame left to serve.
+         */
+        bool step();
+
+        /**
+         * @brief Restarts the replay from the first frame.
+         */
+        void rewind();
+
+        /**
+         * @brief Gets the index of the frame that is currently being served.
+         */
+        [[nodiscard]] int64_t get_position() const;
+
+        /**
+         * @brief Gets the amount of frames in the recording.
+         */
+        [[nodiscard]] int64_t get_frame_count() const { return frame_count_; }
+
+    private:
+        [[nodiscard]] int64_t compute_position() const;
+
+        /**
+         * @brief Gets the amount of frames that passed since the start, unclamped.
+         */
+        [[nodiscard]] int64_t compute_elapsed_frames() const;
+
+        /**
+         * @brief Whether the replay moved past its last frame, the mutex must be held.
+         */
+        [[nodiscard]] bool is_finished() const;
+
+        const cv::Mat& get_image(int64_t position);
+
+        std::filesystem::path path_;
+        float speed_;
+        double fps_;
+        bool loop_;
+
+        std::vector<std::filesystem::path> images_;
+        cv::VideoCapture video_;
+        int64_t video_position_ = -1;
+        int64_t frame_count_ = 0;
+
+        int64_t stepped_ = 0;
+        std::chrono::steady_clock::time_point started_;
+
+        int64_t loaded_position_ = -1;
+        cv::Mat loaded_;
+
+        mutable std::mutex mutex_;
+    };
+
+    /**
+     * @brief Installs the source that all captures are served from.
+     *
+     * @param source The source to install, nullptr to restore the live GDI capture.
+     */
+    void set_frame_source(std::shared_ptr<frame_source> source);
+
+    /**
+     * @brief Gets the source that all captures are currently served from.
+     */
+    [[nodiscard]] std::shared_ptr<frame_source> get_frame_source();
+}
@@ -3,8 +3,14 @@
 #include <windows.h>
 #include "asa/game/settings.h"
 #include "asa/game/embedded.h"
+#include "asa/game/frame.h"
+#include "asa/vision/glyph_ocr.h"
+#include "asa/vision/ocr_engine_pool.h"
+#include "asa/vision/template_match.h"
 
+#include <future>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 #include <opencv2/core.hpp>
@@ -61,7 +67,8 @@ namespace asa
     /**
      * @brief Attempts to initialize tesseract if its not already initialized.
      *
-     * Tesseract initialization is required to perform OCR.
+     * Tesseract initialization is required to perform OCR, this initializes the
+     * first engine of the OCR engine pool, more are created as OCR needs them.
      *
      * @throws tesseract_not_initialized If the tesseract engine could not be initialized.
      */
@@ -191,13 +198,28 @@ namespace asa
      * PrintWindow function so that anything on top of the window will not interfere.
      *
      * @param region A cv::Rect containing the area of the window to screenshot.
-     * @param direct_capture Whether to capture the window based on the hwnd.
+     * @param direct_capture Whether to capture the window based on the hwnd, if false
+     * the desktop is captured through BitBlt regardless of the installed frame source.
      *
      * @return A cv::Mat containing the screenshot of the window.
+     *
+     * @remark The image is served by the installed frame source, see `set_frame_source`.
+     * @remark If a frame is pinned on the calling thread by a `frame_scope`, the region
+     * is taken from the pinned frame instead and no capture is performed.
      */
     [[nodiscard]] cv::Mat screenshot(const cv::Rect& region = {0, 0, 1920, 1080},
                                      bool direct_capture = true);
 
+    /**
+     * @brief Gets a region of a previously captured frame.
+     *
+     * @param frame The frame to take the region from.
+     * @param region A cv::Rect containing the area of the frame to get.
+     *
+     * @return A cv::Mat containing a copy of the region of the frame.
+     */
+    [[nodiscard]] cv::Mat screenshot(const frame& frame, const cv::Rect& region);
+
     /**
      * @brief Gets the pixel color at the given coordinate using the window handle so that
      * anything on top of the window will not interefere.
@@ -248,6 +270,28 @@ namespace asa
                                                  float* top = nullptr,
                                                  int mode = cv::TM_CCOEFF_NORMED);
 
+    /**
+    * @brief Locates a template within a given region of a captured frame.
+    *
+    * @param _template The template to match, must already be loaded into memory.
+    * @param frame The frame to match the template in.
+    * @param region The region of the frame to match the template in.
+    * @param threshold The minimum confidence for a match to be considered.
+    * @param mask [OPTIONAL] A mask to exclude an area of the template in the match.
+    * @param top  [OPTIONAL] A pointer to a float to store the best match in.
+    * @param mode [OPTIONAL] The mode used to template match, default TM_CCOEFF_NORMED.
+    *
+    * @return An std::optional containing a cv::Rect of where the template matched.
+    */
+    [[nodiscard]] std::optional<cv::Rect> locate(const cv::Mat& _template,
+                                                 const frame& frame,
+                                                 const cv::Rect& region,
+                                                 float threshold = 0.7,
+                                                 bool grayscale = false,
+                                                 const cv::Mat& mask = {},
+                                                 float* top = nullptr,
+                                                 int mode = cv::TM_CCOEFF_NORMED);
+
     /**
     * @brief Locates ALL matches of a template within a given image.
     *
@@ -256,13 +300,11 @@ namespace asa
     * @param threshold The minimum confidence for a match to be considered.
     * @param mask [OPTIONAL] A mask to exclude an area of the template in the match.
     *
-    * @return A vector consisting of cv::Rect's of the matches found.
+    * @return The matches found and their scores, best match first.
     */
-    [[nodiscard]] std::vector<cv::Rect> locate_all(const cv::Mat& _template,
-                                                   const cv::Mat& source,
-                                                   float threshold = 0.7,
-                                                   bool grayscale = false,
-                                                   const cv::Mat& mask = {});
+    [[nodiscard]] std::vector<vision::scored_match> locate_all(
+        const cv::Mat& _template, const cv::Mat& source, float threshold = 0.7,
+        bool grayscale = false, const cv::Mat& mask = {});
 
     /**
     * @brief Locates ALL matches of a template within a given region on the screen.
@@ -272,13 +314,26 @@ namespace asa
     * @param threshold The minimum confidence for a match to be considered.
     * @param mask [OPTIONAL] A mask to exclude an area of the template in the match.
     *
-    * @return A vector consisting of cv::Rect's of the matches found.
+    * @return The matches found and their scores, best match first.
     */
-    [[nodiscard]] std::vector<cv::Rect> locate_all(const cv::Mat& _template,
-                                                   const cv::Rect& region,
-                                                   float threshold = 0.7,
-                                                   bool grayscale = false,
-                                                   const cv::Mat& mask = {});
+    [[nodiscard]] std::vector<vision::scored_match> locate_all(
+        const cv::Mat& _template, const cv::Rect& region, float threshold = 0.7,
+        bool grayscale = false, const cv::Mat& mask = {});
+
+    /**
+    * @brief Locates ALL matches of a template within a given region of a captured frame.
+    *
+    * @param _template The template to match, must already be loaded into memory.
+    * @param frame The frame to match the template in.
+    * @param region The region of the frame to match the template in.
+    * @param threshold The minimum confidence for a match to be considered.
+    * @param mask [OPTIONAL] A mask to exclude an area of the template in the match.
+    *
+    * @return The matches found and their scores, best match first.
+    */
+    [[nodiscard]] std::vector<vision::scored_match> locate_all(
+        const cv::Mat& _template, const frame& frame, const cv::Rect& region,
+        float threshold = 0.7, bool grayscale = false, const cv::Mat& mask = {});
 
     /**
     * @brief Thin wrapper of locate to return a boolean instead of std::optional.
@@ -309,7 +364,171 @@ namespace asa
                              const cv::Mat& mask = {});
 
     /**
-     * @brief Uses the tesseract engine to extract text from the provided image.
+    * @brief Thin wrapper of locate to return a boolean instead of std::optional.
+    *
+    * @param _template The template to match, must already be loaded into memory.
+    * @param frame The frame to match the template in.
+    * @param region The region of the frame to match the template in.
+    * @param threshold The minimum confidence for a match to be considered.
+    * @param mask [OPTIONAL] A mask to exclude an area of the template in the match.
+    *
+    * @return True if a match was found, false otherwise.
+    */
+    [[nodiscard]] bool match(const cv::Mat& _template, const frame& frame,
+                             const cv::Rect& region, float threshold = 0.7,
+                             bool grayscale = false, const cv::Mat& mask = {});
+
+    /**
+     * @brief Locates a prepared template within a given image.
+     *
+     * @param _template The prepared template to match, its mask is used if it has one.
+     * @param source The source image to find the template in.
+     * @param threshold The minimum confidence for a match to be considered.
+     * @param grayscale Whether to match the single-channel variants of the images.
+     * @param top  [OPTIONAL] A pointer to a float to store the best match in.
+     * @param mode [OPTIONAL] The mode used to template match, default TM_CCOEFF_NORMED.
+     *
+     * @return An std::optional containing a cv::Rect of where the template matched.
+     */
+    [[nodiscard]] std::optional<cv::Rect> locate(const vision::prepared_template& _template,
+                                                 const cv::Mat& source,
+                                                 float threshold = 0.7,
+                                                 bool grayscale = false,
+                                                 float* top = nullptr,
+                                                 int mode = cv::TM_CCOEFF_NORMED);
+
+    /**
+     * @brief Locates a prepared template within a given region on the screen.
+     *
+     * @param _template The prepared template to match, its mask is used if it has one.
+     * @param region The region of the screen to match the template in.
+     * @param threshold The minimum confidence for a match to be considered.
+     * @param grayscale Whether to match the single-channel variants of the images.
+     * @param top  [OPTIONAL] A pointer to a float to store the best match in.
+     * @param mode [OPTIONAL] The mode used to template match, default TM_CCOEFF_NORMED.
+     *
+     * @return An std::optional containing a cv::Rect of where the template matched.
+     */
+    [[nodiscard]] std::optional<cv::Rect> locate(const vision::prepared_template& _template,
+                                                 const cv::Rect& region,
+                                                 float threshold = 0.7,
+                                                 bool grayscale = false,
+                                                 float* top = nullptr,
+                                                 int mode = cv::TM_CCOEFF_NORMED);
+
+    /**
+     * @brief Locates a prepared template within a given region of a captured frame.
+     *
+     * @param _template The prepared template to match, its mask is used if it has one.
+     * @param frame The frame to match the template in.
+     * @param region The region of the frame to match the template in.
+     * @param threshold The minimum confidence for a match to be considered.
+     * @param grayscale Whether to match the single-channel variants of the images.
+     * @param top  [OPTIONAL] A pointer to a float to store the best match in.
+     * @param mode [OPTIONAL] The mode used to template match, default TM_CCOEFF_NORMED.
+     *
+     * @return An std::optional containing a cv::Rect of where the template matched.
+     */
+    [[nodiscard]] std::optional<cv::Rect> locate(const vision::prepared_template& _template,
+                                                 const frame& frame,
+                                                 const cv::Rect& region,
+                                                 float threshold = 0.7,
+                                                 bool grayscale = false,
+                                                 float* top = nullptr,
+                                                 int mode = cv::TM_CCOEFF_NORMED);
+
+    /**
+     * @brief Locates ALL matches of a prepared template within a given image.
+     *
+     * @param _template The prepared template to match, its mask is used if it has one.
+     * @param source The source image to find the template in.
+     * @param threshold The minimum confidence for a match to be considered.
+     * @param grayscale Whether to match the single-channel variants of the images.
+     *
+     * @return The matches found and their scores, best match first.
+     */
+    [[nodiscard]] std::vector<vision::scored_match> locate_all(
+        const vision::prepared_template& _template, const cv::Mat& source,
+        float threshold = 0.7, bool grayscale = false);
+
+    /**
+     * @brief Locates ALL matches of a prepared template within a region on the screen.
+     *
+     * @param _template The prepared template to match, its mask is used if it has one.
+     * @param region The region of the screen to match the template in.
+     * @param threshold The minimum confidence for a match to be considered.
+     * @param grayscale Whether to match the single-channel variants of the images.
+     *
+     * @return The matches found and their scores, best match first.
+     */
+    [[nodiscard]] std::vector<vision::scored_match> locate_all(
+        const vision::prepared_template& _template, const cv::Rect& region,
+        float threshold = 0.7, bool grayscale = false);
+
+    /**
+     * @brief Locates ALL matches of a prepared template within a region of a frame.
+     *
+     * @param _template The prepared template to match, its mask is used if it has one.
+     * @param frame The frame to match the template in.
+     * @param region The region of the frame to match the template in.
+     * @param threshold The minimum confidence for a match to be considered.
+     * @param grayscale Whether to match the single-channel variants of the images.
+     *
+     * @return The matches found and their scores, best match first.
+     */
+    [[nodiscard]] std::vector<vision::scored_match> locate_all(
+        const vision::prepared_template& _template, const frame& frame,
+        const cv::Rect& region, float threshold = 0.7, bool grayscale = false);
+
+    /**
+     * @brief Thin wrapper of locate to return a boolean instead of std::optional.
+     *
+     * @param _template The prepared template to match, its mask is used if it has one.
+     * @param source The source image to find the template in.
+     * @param threshold The minimum confidence for a match to be considered.
+     * @param grayscale Whether to match the single-channel variants of the images.
+     *
+     * @return True if a match was found, false otherwise.
+     */
+    [[nodiscard]] bool match(const vision::prepared_template& _template,
+                             const cv::Mat& source, float threshold = 0.7,
+                             bool grayscale = false);
+
+    /**
+     * @brief Thin wrapper of locate to return a boolean instead of std::optional.
+     *
+     * @param _template The prepared template to match, its mask is used if it has one.
+     * @param region The region of the screen to match the template in.
+     * @param threshold The minimum confidence for a match to be considered.
+     * @param grayscale Whether to match the single-channel variants of the images.
+     *
+     * @return True if a match was found, false otherwise.
+     */
+    [[nodiscard]] bool match(const vision::prepared_template& _template,
+                             const cv::Rect& region, float threshold = 0.7,
+                             bool grayscale = false);
+
+    /**
+     * @brief Thin wrapper of locate to return a boolean instead of std::optional.
+     *
+     * @param _template The prepared template to match, its mask is used if it has one.
+     * @param frame The frame to match the template in.
+     * @param region The region of the frame to match the template in.
+     * @param threshold The minimum confidence for a match to be considered.
+     * @param grayscale Whether to match the single-channel variants of the images.
+     *
+     * @return True if a match was found, false otherwise.
+     */
+    [[nodiscard]] bool match(const vision::prepared_template& _template,
+                             const frame& frame, const cv::Rect& region,
+                             float threshold = 0.7, bool grayscale = false);
+
+    /**
+     * @brief Uses an engine of the OCR engine pool to extract text from the image,
+     * calls from different threads run in parallel on different engines.
+     *
+     * Results are cached by the content of the image, reading the same pixels with
+     * the same settings again returns the cached result without running tesseract.
      *
      * @param src The image to extract the text from, preprocessing should be done before.
      * @param mode The page segmentation mode to use for the text extraction.
@@ -322,4 +541,61 @@ namespace asa
     [[nodiscard]] std::string ocr_threadsafe(const cv::Mat& src,
                                              tesseract::PageSegMode mode,
                                              const char* whitelist);
+
+    /**
+     * @brief Reads the text of a line in a fixed font through a glyph set, falling
+     * back to tesseract if the glyphs could not be read confidently.
+     *
+     * Text that tesseract reads with a high confidence is learned by the glyph set,
+     * so that the next read of the same glyphs doesnt need tesseract.
+     *
+     * @param src The binary mask of the line to read.
+     * @param glyphs The glyph set of the font of the line.
+     * @param mode The page segmentation mode to use for the tesseract fallback.
+     * @param whitelist The character whitelist to use for the tesseract fallback.
+     * @param min_confidence The minimum confidence of a glyph read to be used.
+     *
+     * @return The content extracted from the image, may be faulty!
+     */
+    [[nodiscard]] std::string ocr_threadsafe(const cv::Mat& src,
+                                             vision::glyph_set& glyphs,
+                                             tesseract::PageSegMode mode,
+                                             const char* whitelist,
+                                             float min_confidence = 0.8f);
+
+    /**
+     * @brief An image to extract text from and how to extract it.
+     */
+    struct ocr_request
+    {
+        cv::Mat src;
+        tesseract::PageSegMode mode;
+        std::string whitelist;
+
+        // if set, the image is read through the glyph set first, see `ocr_threadsafe`.
+        vision::glyph_set* glyphs = nullptr;
+        float min_confidence = 0.8f;
+    };
+
+    /**
+     * @brief Extracts the text of a request on the library thread pool.
+     *
+     * @param request The request to extract the text of.
+     *
+     * @return A future for the text and its confidence.
+     *
+     * @remark Must not be waited on from a task of the thread pool, use `ocr_batch`.
+     */
+    [[nodiscard]] std::future<vision::ocr_result> ocr_async(ocr_request request);
+
+    /**
+     * @brief Extracts the text of all requests at once, the requests are spread over
+     * the engines of the OCR engine pool and the calling thread.
+     *
+     * @param requests The requests to extract the text of.
+     *
+     * @return The text and confidence of every request in the order of the requests.
+     */
+    [[nodiscard]] std::vector<vision::ocr_result> ocr_batch(
+        std::span<const ocr_request> requests);
 }
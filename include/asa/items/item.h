@@ -64,10 +64,10 @@ namespace asa
         [[nodiscard]] bool is_exported() const;
 
         /** 
-         * @brief Creates a mat (CV_8UC3) holding the items icon sized to match in inventories.
+         * @brief Gets a mat (CV_8UC3) holding the items icon sized to match in inventories.
          *
-         * @remark Gets created upon the first call and is stored on the heap for efficiency.
-         * @remark The CV_8UC4 icon created as a byproduct is required to create the mask.
+         * @remark The icon is scaled at build time and refers to the asset pack, it is
+         * shared by every user and must be cloned before writing to it.
          * @remark The icon is guaranteed to be of uniform size for all exported assets.
          *
          * @return The icon of this item sized for the inventory.
@@ -75,21 +75,21 @@ namespace asa
         [[nodiscard]] const cv::Mat& get_inventory_icon() const { return inv_icon_; }
 
         /** 
-         * @brief Creates a bitmask (CV_8UC1) for the alpha channel of the inventory icon.
+         * @brief Gets a bitmask (CV_8UC1) for the alpha channel of the inventory icon.
          *
-         * @remark Gets created upon the first call and is stored on the heap for efficiency.
+         * @remark The mask is created at build time and refers to the asset pack, it is
+         * shared by every user and must be cloned before writing to it.
          * @remark The mask is guaranteed to be of the same size as the inventory icon.
-         * @remark If the inventory icon has not been created, it will be called first.
          *
          * @return The mask of this item sized for the inventory.
          */
         [[nodiscard]] const cv::Mat& get_inventory_icon_mask() const { return inv_icon_mask_; }
 
         /** 
-         * @brief Creates a mat (CV_8UC3) holding the items icon sized to match notifications.
+         * @brief Gets a mat (CV_8UC3) holding the items icon sized to match notifications.
          *
-         * @remark Gets created upon the first call and is stored on the heap for efficiency.
-         * @remark The CV_8UC4 icon created as a byproduct is required to create the mask.
+         * @remark The icon is scaled at build time and refers to the asset pack, it is
+         * shared by every user and must be cloned before writing to it.
          * @remark The icon is guaranteed to be of uniform size for all exported assets.
          *
          * @return The icon of this item sized for the notifications.
@@ -97,11 +97,11 @@ namespace asa
         [[nodiscard]] const cv::Mat& get_notification_icon() const { return notif_icon_; }
 
         /** 
-         * @brief Creates a bitmask (CV_8UC1) for the alpha channel of the notification icon.
+         * @brief Gets a bitmask (CV_8UC1) for the alpha channel of the notification icon.
          *
-         * @remark Gets created upon the first call and is stored on the heap for efficiency.
+         * @remark The mask is created at build time and refers to the asset pack, it is
+         * shared by every user and must be cloned before writing to it.
          * @remark The mask is guaranteed to be of the same size as the notfication icon.
-         * @remark If the notification icon has not been created, it will be called first.
          *
          * @return The mask of this item sized for the notifications.
          */
@@ -111,12 +111,9 @@ namespace asa
         std::string name_;
         item_data data_;
 
-        cv::Mat icon_;
-        cv::Mat rgba_inv_icon_;
         cv::Mat inv_icon_mask_;
         cv::Mat inv_icon_;
 
-        cv::Mat rgba_notif_icon_;
         cv::Mat notif_icon_mask_;
         cv::Mat notif_icon_;
     };
@@ -0,0 +1,78 @@
+#pragma once
+#include "item.h"
+
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace asa
+{
+    /**
+     * @brief An index of compact descriptors of the inventory icons of all items, used
+     * to tell which few items an icon on screen could be before template matching.
+     *
+     * A descriptor is a coarse color histogram and a difference hash of the visible
+     * pixels of an icon. Both ignore where exactly the icon is and how it was scaled,
+     * so they are cheap to compare but only good enough to rank the candidates.
+     */
+    class item_index
+    {
+    public:
+        // 4 levels per channel, 64 bins.
+        static constexpr int HISTOGRAM_BINS = 64;
+
+        struct descriptor
+        {
+            // the share of the visible pixels in every bin, summing up to about 255.
+            std::array<uint8_t, HISTOGRAM_BINS> histogram{};
+            uint64_t hash = 0;
+        };
+
+        struct candidate
+        {
+            const item* match;
+            float distance;
+        };
+
+        using filter_t = std::function<bool(const item&)>;
+
+        /**
+         * @brief Computes the descriptor of the visible pixels of an icon.
+         *
+         * @param src The BGR or BGRA image of the icon.
+         * @param mask The CV_8U mask of the visible pixels, all pixels if empty.
+         */
+        [[nodiscard]] static descriptor describe(const cv::Mat& src, const cv::Mat& mask);
+
+        /**
+         * @brief Computes the distance of two descriptors within [0, 1].
+         */
+        [[nodiscard]] static float distance(const descriptor& a, const descriptor& b);
+
+        /**
+         * @brief Adds the inventory icon of an item to the index.
+         *
+         * @remark The item must outlive the index.
+         */
+        void add(const item& item);
+
+        /**
+         * @brief Gets the items whose icons are the most similar to a descriptor.
+         *
+         * @param query The descriptor of the icon to find the items of.
+         * @param count The maximum amount of candidates to get.
+         * @param filter Called to rule out items before they are compared, if given.
+         *
+         * @return The candidates, the most similar first.
+         */
+        [[nodiscard]] std::vector<candidate> shortlist(const descriptor& query,
+                                                       size_t count,
+                                                       const filter_t& filter = {}) const;
+
+        [[nodiscard]] size_t size() const { return items_.size(); }
+
+    private:
+        std::vector<descriptor> descriptors_;
+        std::vector<const item*> items_;
+    };
+}
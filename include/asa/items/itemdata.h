@@ -50,6 +50,7 @@ namespace asa
         bool operator==(const item_data&) const = default;
 
         std::filesystem::path icon_path;
+        bool icon_exported;
         ItemType type;
         ItemQuality quality;
 
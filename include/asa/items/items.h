@@ -1,5 +1,6 @@
 #pragma once
 #include "item.h"
+#include "item_index.h"
 #include "exceptions.h"
 
 namespace asa
@@ -9,4 +10,9 @@ namespace asa
     const item& get_item(const std::string& name);
 
     const std::map<std::string, std::unique_ptr<item> >& get_all_items();
+
+    /**
+     * @brief Gets the index of the inventory icons of all items, built by `load_items`.
+     */
+    const item_index& get_item_index();
 }
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+#include <array>
+#include <filesystem>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <opencv2/core.hpp>
+
+namespace asa
+{
+    /**
+     * @brief Remembers where within a slot the icon of an item was found, so that
+     * the next match of the item only has to search a small window around it.
+     *
+     * The entries are spread over shards that are locked separately, so slots may be
+     * matched from many threads at once. An icon that is not in its window is usually
+     * not in the slot at all, so an entry only counts a miss once a search of the whole
+     * slot found the icon outside of its window, and is dropped if that keeps happening.
+     */
+    class icon_offset_cache
+    {
+    public:
+        struct entry
+        {
+            // the window to search the icon in, relative to the slot.
+            cv::Rect window;
+            // the running average of the accuracies the icon was found with.
+            float confidence = 0.f;
+            // the amount of times in a row the icon was found outside of the window.
+            int misses = 0;
+            // the amount of matches in a row that did not find the icon in the window.
+            int unmatched = 0;
+        };
+
+        /**
+         * @param t_verify_interval After how many unmatched windows in a row to check
+         * whether the icon moved.
+         * @param t_max_misses After how many misses in a row to drop an entry.
+         */
+        explicit icon_offset_cache(int t_verify_interval = 8, int t_max_misses = 4);
+
+        /**
+         * @brief Gets the entry of an item, if its offset was learned.
+         */
+        [[nodiscard]] std::optional<entry> find(const std::string& item) const;
+
+        /**
+         * @brief Learns (or relearns) the window of an item.
+         *
+         * @param item The name of the item.
+         * @param window The window to search its icon in from now on.
+         * @param accuracy The accuracy the icon was found with.
+         */
+        void learn(const std::string& item, const cv::Rect& window, float accuracy);
+
+        /**
+         * @brief Records that the icon of an item was found in its window.
+         */
+        void hit(const std::string& item, float accuracy);
+
+        /**
+         * @brief Records that the icon of an item was not found in its window, which
+         * leaves the entry as it is.
+         *
+         * @return True if the icon should be searched in the whole slot to tell
+         * whether it moved, false otherwise.
+         */
+        bool unmatched(const std::string& item);
+
+        /**
+         * @brief Records that a search of the whole slot found the icon of an item
+         * outside of its window, drops the entry if it missed too often in a row.
+         *
+         * @param item The name of the item.
+         * @param window The window around where the icon was found instead.
+         * @param accuracy The accuracy the icon was found with.
+         */
+        void miss(const std::string& item, const cv::Rect& window, float accuracy);
+
+        void forget(const std::string& item);
+
+        void clear();
+
+        [[nodiscard]] size_t size() const;
+
+        /**
+         * @brief Loads the entries of a file saved before, replacing known entries.
+         *
+         * @return True if the file was read, false if it does not exist or failed.
+         */
+        bool load(const std::filesystem::path& path);
+
+        /**
+         * @brief Saves all entries to a file.
+         *
+         * @return True if the file was written, false otherwise.
+         */
+        bool save(const std::filesystem::path& path) const;
+
+    private:
+        static constexpr size_t NUM_SHARDS = 16;
+
+        struct shard
+        {
+            mutable std::shared_mutex mutex;
+            std::unordered_map<std::string, entry> entries;
+        };
+
+        [[nodiscard]] shard& shard_of(const std::string& item);
+
+        [[nodiscard]] const shard& shard_of(const std::string& item) const;
+
+        int verify_interval_;
+        int max_misses_;
+        std::array<shard, NUM_SHARDS> shards_;
+    };
+
+    /**
+     * @brief Gets the icon offset cache shared by all slots.
+     */
+    [[nodiscard]] icon_offset_cache& get_icon_offset_cache();
+}
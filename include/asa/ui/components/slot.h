@@ -2,9 +2,14 @@
 #include "tooltip.h"
 #include "interface_component.h"
 #include "asa/items/item.h"
+#include "asa/items/item_index.h"
+
+#include <span>
 
 namespace asa
 {
+    class inventory_snapshot;
+
     struct item_slot : interface_component
     {
     public:
@@ -111,6 +116,18 @@ namespace asa
          */
         [[nodiscard]] std::unique_ptr<item> get_item() const;
 
+        /**
+         * @brief Determines the item located in the slot from the attributes that a
+         * snapshot of its page decoded, without looking at them again.
+         *
+         * @param snapshot The snapshot of the page of the slot.
+         * @param position The position of the slot on the page.
+         *
+         * @return A unique pointer to the determined item object.
+         */
+        [[nodiscard]] std::unique_ptr<item> get_item(const inventory_snapshot& snapshot,
+                                                     size_t position) const;
+
         /**
          * @brief Gets the durability of the item located in the slot.
          *
@@ -146,6 +163,8 @@ namespace asa
         friend std::ostream& operator<<(std::ostream& os,
                                         const predetermination_result& d);
 
+        friend class inventory_snapshot;
+
     private:
         /**
          * @brief Checks whether the item in this slot has an armor modifier.
@@ -228,6 +247,28 @@ namespace asa
          */
         [[nodiscard]] predetermination_result predetermine() const;
 
+        /**
+         * @brief Finds the item that matches the slot best among the items whose icons
+         * look the most alike.
+         *
+         * @param data The data collected about the item in the slot.
+         *
+         * @return The best matching item or nullptr if none matched.
+         *
+         * @remark The closest few items are matched first, the shortlist is widened
+         * only if none of them is found.
+         */
+        [[nodiscard]] const item* identify(const predetermination_result& data) const;
+
+        /**
+         * @brief Template matches the candidates against the last image of the slot.
+         *
+         * @return The best candidate that was found with the confidence of its
+         * category, nullptr if none was.
+         */
+        [[nodiscard]] const item* identify(
+            std::span<const item_index::candidate> candidates) const;
+
         mutable cv::Mat last_img_;
     };
 }
@@ -98,7 +98,8 @@ namespace asa
     private:
         hud() = default;
 
-        bool detect_push_notification(const cv::Mat& notification, float variance = 0.7f);
+        bool detect_push_notification(const vision::prepared_template& notification,
+                                      float variance = 0.7f);
 
         cv::Vec3b blink_red_state_{109, 54, 52};
         cv::Vec3b blink_red_state_weight_{255, 45, 45};
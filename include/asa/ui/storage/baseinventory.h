@@ -1,6 +1,7 @@
 #pragma once
 #include "asa/ui/asainterface.h"
 #include "asa/ui/components/components.h"
+#include "asa/ui/storage/inventory_snapshot.h"
 #include "asa/ui/info/baseinfo.h"
 #include "asa/game/window.h"
 
@@ -283,7 +284,7 @@ namespace asa
          *
          * @param allowed_items Whitelist of allowed items, other items are not checked.
          * @param allowed_categories Whitelist of allowed item types, others are not checked.
-         * @param num_threads The number of threads to use, default 5.
+         * @param num_threads The maximum number of threads to use, default 5.
          *
          * @return A vector containing unique pointers to all items  in the current page.
          *
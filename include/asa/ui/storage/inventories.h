@@ -3,5 +3,6 @@
 #include "craftinginventory.h"
 #include "dinoinventory.h"
 #include "inventories.h"
+#include "inventory_snapshot.h"
 #include "localinventory.h"
 #include "tribute_inventory.h"
@@ -0,0 +1,93 @@
+#pragma once
+#include "asa/ui/components/slot.h"
+#include "asa/game/frame.h"
+
+#include <array>
+#include <bitset>
+#include <span>
+
+namespace asa
+{
+    /**
+     * @brief The state of every slot of an inventory page decoded from a single frame.
+     *
+     * The attributes of every slot are decoded from the same frame and kept as one
+     * array per attribute, indexed by the index of the slot on the page.
+     *
+     * @remark The attributes of the item in a slot are only decoded if the slot is
+     * neither empty nor a folder, a slot is empty exactly if `item_slot::is_empty`.
+     */
+    class inventory_snapshot
+    {
+    public:
+        static constexpr size_t MAX_SLOTS = 36;
+
+        /**
+         * @brief Decodes the slots of a page from a frame.
+         *
+         * @param t_slots The slots of the page, at most MAX_SLOTS.
+         * @param t_frame The frame to decode them from, a new frame if nullptr.
+         * @param t_with_items Whether to decode the attributes of the items, otherwise
+         * only whether the slots are empty or folders is decoded.
+         */
+        explicit inventory_snapshot(std::span<const item_slot> t_slots,
+                                    frame_ptr t_frame = nullptr,
+                                    bool t_with_items = true);
+
+        [[nodiscard]] bool is_empty(const size_t slot) const { return empty_[slot]; }
+
+        [[nodiscard]] bool is_folder(const size_t slot) const { return folder_[slot]; }
+
+        [[nodiscard]] bool is_stack(const size_t slot) const { return stack_[slot]; }
+
+        [[nodiscard]] bool has_armor_value(const size_t slot) const
+        {
+            return armor_[slot];
+        }
+
+        [[nodiscard]] bool has_damage_value(const size_t slot) const
+        {
+            return damage_[slot];
+        }
+
+        [[nodiscard]] bool has_spoil_timer(const size_t slot) const
+        {
+            return spoil_[slot];
+        }
+
+        [[nodiscard]] bool has_durability(const size_t slot) const
+        {
+            return durability_[slot];
+        }
+
+        [[nodiscard]] item_data::ItemQuality get_quality(const size_t slot) const
+        {
+            return quality_[slot];
+        }
+
+        /**
+         * @brief Gets the index of the first empty slot, the amount of slots if none.
+         */
+        [[nodiscard]] size_t get_first_empty() const;
+
+        [[nodiscard]] size_t get_num_slots() const { return num_slots_; }
+
+        /**
+         * @brief Gets the frame the snapshot was decoded from.
+         */
+        [[nodiscard]] const frame_ptr& get_frame() const { return frame_; }
+
+    private:
+        frame_ptr frame_;
+        size_t num_slots_;
+
+        std::bitset<MAX_SLOTS> empty_;
+        std::bitset<MAX_SLOTS> folder_;
+        std::bitset<MAX_SLOTS> stack_;
+        std::bitset<MAX_SLOTS> armor_;
+        std::bitset<MAX_SLOTS> damage_;
+        std::bitset<MAX_SLOTS> spoil_;
+        std::bitset<MAX_SLOTS> durability_;
+        std::array<item_data::ItemQuality, MAX_SLOTS> quality_{};
+    };
+}
@@ -3,16 +3,40 @@
 #include "asa/ui/components/button.h"
 #include "asa/ui/components/search_bar.h"
 #include "asa/ui/components/tribelog_message.h"
+#include "asa/ui/tribelog_store.h"
+#include "asa/vision/perceptual_hash.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
 
 namespace asa
 {
     using log_entries_t = std::vector<tribelog_message>;
+
+    /**
+     * @brief Called once a tribelog update was processed.
+     *
+     * @param all The last 50 stored messages newest first, as read from the store they
+     * have no raw image, see `tribelog_store::latest` to get their thumbnails.
+     * @param new_ The messages that were new in the update, with their raw images.
+     */
     using log_update_callback_t = std::function<void(const log_entries_t& all,
                                                      const log_entries_t& new_)>;
 
     class tribe_manager final : public asainterface
     {
     public:
+        /**
+         * @param t_log_directory The directory to store the tribelog history in, by
+         * default "tribelogs" next to the executable.
+         *
+         * @remark The store is only opened by the first update or query, so that
+         * constructing the interface never fails.
+         */
+        explicit tribe_manager(std::filesystem::path t_log_directory = {});
+
         /**
          * @brief Checks whether the tribe manager is currently open.
          */
@@ -35,10 +59,14 @@ namespace asa
          * @param on_finish The function to call with the update results.
          * @param receive_for The duration to let the game receive new events in seconds.
          *
+         * @return True if the update was started, false if the previous update is
+         * still being processed, in which case nothing is done.
+         *
          * @remark What events are new and which arent is determined by their timestamp.
          * @remark The stored logs updated and may be used instead of a callback.
+         * @remark The rows of the logs are parsed concurrently.
          */
-        void update_tribelogs(const log_update_callback_t& on_finish,
+        bool update_tribelogs(const log_update_callback_t& on_finish,
                               std::chrono::seconds receive_for = std::chrono::seconds(1));
 
         /**
@@ -47,9 +75,19 @@ namespace asa
         [[nodiscard]] cv::Mat get_current_logs_image() const;
 
         /**
-         * @brief Gets the last 50 saved log entries.
+         * @brief Gets the last 50 saved log entries, newest first.
+         *
+         * @remark The entries are kept in memory until another message is stored, they
+         * have no raw images.
          */
-        [[nodiscard]] const log_entries_t& get_logs() const { return tribelog_; }
+        [[nodiscard]] log_entries_t get_logs() const;
+
+        /**
+         * @brief Gets the store of all saved log entries, for queries of the history.
+         *
+         * @throws asapp_error If the store could not be opened.
+         */
+        [[nodiscard]] const tribelog_store& get_store() const { return store(); }
 
     private:
         /**
@@ -111,10 +149,9 @@ namespace asa
          *
          * @param message The message to add.
          *
-         * @remarks If the size of the tribelog history exceeds 50, the last message
-         * is deleted in order to make room.
+         * @return True if the message was added, false if it was in the history already.
          */
-        void add_message(const tribelog_message& message);
+        bool add_message(const tribelog_message& message);
 
         /**
          * @brief Checks whether a message is a new message based on its timestamp.
@@ -125,7 +162,28 @@ namespace asa
         [[nodiscard]] bool is_new_message(tribelog_message::timestamp msg,
                                           bool allow_equal) const;
 
-        log_entries_t tribelog_;
+        /**
+         * @brief Gets the store, opening it on the first call.
+         *
+         * @throws asapp_error If the store could not be opened, the next call tries
+         * to open it again.
+         */
+        [[nodiscard]] tribelog_store& store() const;
+
+        std::filesystem::path log_directory_;
+        mutable std::once_flag store_opened_;
+        mutable std::unique_ptr<tribelog_store> store_;
+
+        // the result of get_logs, reset whenever a message is stored.
+        mutable std::mutex logs_mutex_;
+        mutable std::optional<log_entries_t> logs_;
+
+        // set while an update is being processed, further updates are rejected.
+        std::atomic<bool> updating_{false};
+
+        // content hashes of the rows whose message was stored, a row that is still on
+        // screen is identical down to the pixel.
+        vision::fingerprint_set known_rows_{256};
         button close_button_{1781, 49, 36, 33};
         button tribe_manager_button{908, 55, 52, 52};
 
@@ -0,0 +1,172 @@
+#pragma once
+#include "asa/ui/components/tribelog_message.h"
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <shared_mutex>
+#include <vector>
+
+namespace asa
+{
+    /**
+     * @brief An append-only store of tribelog messages on disk.
+     *
+     * Messages are written as compact binary records to log segments in a directory,
+     * the images of the messages are optionally kept as compressed thumbnails in a
+     * file next to each segment. Only a small index of every message is kept in
+     * memory, the messages themselves are read from disk when queried.
+     *
+     * @remark The index is rebuilt from the segments when the store is opened, so
+     * messages that were stored before a restart are still known.
+     * @remark The directory is locked while the store is open, only one store (in
+     * any process) can write to a directory at a time.
+     */
+    class tribelog_store
+    {
+    public:
+        using EventType = tribelog_message::EventType;
+
+        /**
+         * @brief Opens (or creates) the store in a directory.
+         *
+         * @param t_directory The directory to keep the log segments in.
+         * @param t_keep_thumbnails Whether to keep thumbnails of the message images.
+         * @param t_segment_size The size in bytes after which a new segment is started.
+         *
+         * @throws asapp_error If the directory or a segment could not be opened, or
+         * the directory is locked by another store.
+         */
+        explicit tribelog_store(std::filesystem::path t_directory,
+                                bool t_keep_thumbnails = true,
+                                size_t t_segment_size = 4 * 1024 * 1024);
+
+        ~tribelog_store();
+
+        tribelog_store(const tribelog_store&) = delete;
+
+        tribelog_store& operator=(const tribelog_store&) = delete;
+
+        /**
+         * @brief Appends a message to the store unless it is stored already.
+         *
+         * @return True if the message was appended, false if it was a duplicate.
+         *
+         * @throws asapp_error If the message could not be written, whatever part of
+         * it was written is removed again.
+         *
+         * @remark A message is a duplicate of another if its time and content match.
+         */
+        bool append(const tribelog_message& message);
+
+        /**
+         * @brief Checks whether a message with the same time and content is stored.
+         */
+        [[nodiscard]] bool contains(const tribelog_message& message) const;
+
+        /**
+         * @brief Gets all stored messages within a time range, oldest first.
+         *
+         * @param from The earliest time of a message to include.
+         * @param to The latest time of a message to include.
+         * @param with_images Whether to load the thumbnails into the raw images.
+         */
+        [[nodiscard]] std::vector<tribelog_message> range(
+            const tribelog_message::timestamp& from,
+            const tribelog_message::timestamp& to, bool with_images = false) const;
+
+        /**
+         * @brief Gets all stored messages of an event type within a time range,
+         * oldest first.
+         */
+        [[nodiscard]] std::vector<tribelog_message> range(
+            const tribelog_message::timestamp& from,
+            const tribelog_message::timestamp& to, EventType type,
+            bool with_images = false) const;
+
+        /**
+         * @brief Gets the most recent messages, newest first.
+         *
+         * @param count The maximum amount of messages to get.
+         * @param with_images Whether to load the thumbnails into the raw images.
+         */
+        [[nodiscard]] std::vector<tribelog_message> latest(
+            size_t count, bool with_images = false) const;
+
+        /**
+         * @brief Gets the time of the most recent message, if any are stored.
+         */
+        [[nodiscard]] std::optional<tribelog_message::timestamp> get_latest_time() const;
+
+        [[nodiscard]] size_t size() const;
+
+        [[nodiscard]] bool empty() const { return size() == 0; }
+
+    private:
+        // what is kept in memory of every stored message.
+        struct index_entry
+        {
+            int64_t time;
+            uint64_t content_hash;
+            uint32_t segment;
+            uint64_t offset;
+            EventType type;
+        };
+
+        /**
+         * @brief Loads the index of every segment in the directory and opens the last
+         * segment for appending.
+         */
+        void load();
+
+        void load_segment(uint32_t segment);
+
+        void open_segment(uint32_t segment);
+
+        /**
+         * @brief Removes a partially written record from the end of the segment, or
+         * continues in a new segment if the segment can not be truncated.
+         */
+        void rollback();
+
+        void lock_directory();
+
+        void unlock_directory();
+
+        void add_to_index(const index_entry& entry);
+
+        [[nodiscard]] bool contains_locked(int64_t time, uint64_t content_hash) const;
+
+        [[nodiscard]] std::vector<index_entry> collect(
+            const std::vector<uint32_t>& index, int64_t from, int64_t to) const;
+
+        [[nodiscard]] std::vector<tribelog_message> read(
+            const std::vector<index_entry>& entries, bool with_images) const;
+
+        [[nodiscard]] std::filesystem::path segment_path(uint32_t segment) const;
+
+        [[nodiscard]] std::filesystem::path thumbnails_path(uint32_t segment) const;
+
+        std::filesystem::path directory_;
+        bool keep_thumbnails_;
+        size_t segment_size_;
+
+        mutable std::shared_mutex mutex_;
+
+        // every entry in the order it was appended, the indices below refer to it.
+        std::vector<index_entry> entries_;
+        std::vector<uint32_t> by_time_;
+        std::array<std::vector<uint32_t>, EventType::ENEMY_PLAYER_KILLED + 1> by_type_;
+
+        uint32_t segment_ = 0;
+        uint64_t segment_end_ = 0;
+        uint64_t thumbnails_end_ = 0;
+        std::ofstream segment_out_;
+        std::ofstream thumbnails_out_;
+
+        // the handle of the lock file on windows, its descriptor otherwise.
+        void* lock_handle_ = nullptr;
+        int lock_fd_ = -1;
+    };
+}
@@ -1,10 +1,12 @@
 #pragma once
 #include <chrono>
+#include <filesystem>
 #include <functional>
 #include <map>
 #include <fmt/format.h>
 
 #include "game/window.h"
+#include "core/text_replacer.h"
 
 template <>
 struct fmt::formatter<std::chrono::milliseconds> {
@@ -20,6 +22,14 @@ struct fmt::formatter<std::chrono::milliseconds> {
 
 namespace asa::utility
 {
+    /**
+     * @brief Waits for a condition to become true within the given timeout.
+     *
+     * @remark Any frame pinned on the calling thread is ignored while waiting as the
+     * condition must be evaluated on new captures to ever change.
+     * @remark If the capture service is running, the condition is evaluated once per
+     * captured frame rather than paying for a capture on every iteration.
+     */
     bool await(const std::function<bool()>& condition, std::chrono::milliseconds timeout);
 
     std::chrono::system_clock::time_point from_t(time_t time);
@@ -95,6 +105,19 @@ namespace asa::utility
      */
     cv::Mat mask(const cv::Rect& roi, const cv::Vec3b& color, int variance);
 
+    /**
+     * @brief Masks a region of a captured frame using a given color and variance.
+     *
+     * @param frame The frame to create the mask from.
+     * @param roi The area of the frame to create the mask of.
+     * @param color The color to mask the image for.
+     * @param variance The variance a color may have from the given color
+     *
+     * @return A mask of the given region where each matching pixel is 1, else 0.
+     */
+    cv::Mat mask(const frame& frame, const cv::Rect& roi, const cv::Vec3b& color,
+                 int variance);
+
     /**
      * @brief Helper function to create a low and high color range from a color & variance.
      */
@@ -109,9 +132,35 @@ namespace asa::utility
     /**
      * @brief Counts the amount of pixels that match a given color within a given image,
      * allowing for a given variance.
+     *
+     * @remark If a frame is pinned on the thread, its pixels are counted in place.
      */
     int count_matches(const cv::Rect& img, const cv::Vec3b& color, int variance);
 
+    /**
+     * @brief Counts the amount of pixels that match a given color within a region of
+     * a captured frame, allowing for a given variance.
+     */
+    int count_matches(const frame& frame, const cv::Rect& roi, const cv::Vec3b& color,
+                      int variance);
+
+    /**
+     * @brief Counts the amount of pixels that match any of the given colors within a
+     * given image, allowing for a given variance. Equivalent to counting the non zero
+     * pixels of all color masks OR'd together, but done in a single pass.
+     */
+    int count_matches(const cv::Mat& img, const std::vector<cv::Vec3b>& colors,
+                      int variance);
+
+    /**
+     * @brief Counts the amount of pixels that match any of the given colors within a
+     * given region, allowing for a given variance.
+     *
+     * @remark If a frame is pinned on the thread, its pixels are counted in place.
+     */
+    int count_matches(const cv::Rect& roi, const std::vector<cv::Vec3b>& colors,
+                      int variance);
+
     bool pixel_matches(const cv::Vec3b& c1, const cv::Vec3b& c2, int tolerance);
 
     bool roi_in_bounds(const cv::Rect& roi, const cv::Rect& bounds);
@@ -137,5 +186,26 @@ namespace asa::utility
     std::string fix(const std::string& src,
                     const std::map<std::string, std::string>& fixes);
 
+    /**
+     * @brief Returns a string with all common OCR mistakes in a src string fixed
+     * by a compiled replacer.
+     *
+     * Each pass replaces the leftmost longest matches in one sweep over the string,
+     * passes are repeated while a pass replaced anything so that fixes which create
+     * another mistake (e.g. collapsing runs of spaces) are applied as well.
+     *
+     * @param src The source string to find and fix the mistakes in
+     * @param fixes The compiled fixes to apply.
+     */
+    std::string fix(const std::string& src, const text_replacer& fixes);
+
     void to_lower(std::string& str);
+
+    /**
+     * @brief Gets the directory of the running executable, to resolve files that are
+     * shipped or written next to it regardless of the working directory.
+     *
+     * @return The directory, empty if it could not be determined.
+     */
+    std::filesystem::path get_executable_directory();
 }
@@ -0,0 +1,86 @@
+#pragma once
+#include <span>
+#include <opencv2/core.hpp>
+
+namespace asa::vision
+{
+    /**
+     * @brief An inclusive BGR range that a pixel has to be in to match a color.
+     */
+    struct color_range
+    {
+    public:
+        /**
+         * @brief Creates the range of a color allowing the given variance, the same
+         * range that `utility::get_ranges` produces for masking.
+         */
+        static color_range of(const cv::Vec3b& color, int variance);
+
+        [[nodiscard]] bool contains(const uchar* bgr) const
+        {
+            return bgr[0] >= low[0] && bgr[0] <= high[0] &&
+                   bgr[1] >= low[1] && bgr[1] <= high[1] &&
+                   bgr[2] >= low[2] && bgr[2] <= high[2];
+        }
+
+        cv::Vec3b low;
+        cv::Vec3b high;
+    };
+
+    /**
+     * @brief Enables or disables the AVX2 kernels, by default they are used if the CPU
+     * supports AVX2 and the scalar kernels otherwise.
+     *
+     * @return Whether the AVX2 kernels are used from now on, never if the CPU or the
+     * build does not support them.
+     */
+    bool set_avx2_enabled(bool enabled);
+
+    /**
+     * @brief Counts the pixels of an image that are within a color range.
+     *
+     * Fused replacement for `cv::inRange` followed by `cv::countNonZero`, the image
+     * (or ROI of an image) is read exactly once and no memory is allocated.
+     *
+     * @param src The CV_8UC3 image to count the pixels in, may be a ROI.
+     * @param range The range a pixel has to be in to be counted.
+     *
+     * @return The amount of pixels within the range.
+     */
+    [[nodiscard]] int count_in_range(const cv::Mat& src, const color_range& range);
+
+    /**
+     * @brief Counts the pixels of an image that are within any of the color ranges,
+     * i.e the non zero pixels of all masks OR'd together, in a single pass.
+     *
+     * @param src The CV_8UC3 image to count the pixels in, may be a ROI.
+     * @param ranges The ranges a pixel has to be in any of to be counted.
+     *
+     * @return The amount of pixels within at least one of the ranges.
+     */
+    [[nodiscard]] int count_in_ranges(const cv::Mat& src,
+                                      std::span<const color_range> ranges);
+
+    /**
+     * @brief Counts the pixels of an image that are within each of the color ranges in
+     * a single pass, the same as calling `count_in_range` for every range.
+     *
+     * @param src The CV_8UC3 image to count the pixels in, may be a ROI.
+     * @param ranges The ranges to count the pixels of.
+     * @param counts Set to the amount of pixels within each range, must be at least
+     * as large as the ranges.
+     */
+    void count_each_in_ranges(const cv::Mat& src, std::span<const color_range> ranges,
+                              std::span<int> counts);
+
+    /**
+     * @brief Masks the pixels of an image that are within any of the color ranges in
+     * a single pass, the same as OR-ing the masks of `cv::inRange` for every range.
+     *
+     * @param src The CV_8UC3 image to mask the pixels of, may be a ROI.
+     * @param ranges The ranges a pixel has to be in any of to be set.
+     * @param dst The CV_8U mask to write, (re)allocated only if its size differs.
+     */
+    void mask_in_ranges(const cv::Mat& src, std::span<const color_range> ranges,
+                        cv::Mat& dst);
+}
@@ -0,0 +1,147 @@
+#pragma once
+#include <array>
+#include <limits>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <opencv2/core.hpp>
+
+namespace asa::vision
+{
+    /**
+     * @brief The text read by a glyph set and how confident the read is.
+     */
+    struct glyph_read
+    {
+        std::string text;
+
+        // the confidence of the least confident glyph in [0, 1].
+        float confidence;
+    };
+
+    /**
+     * @brief Reads single lines of text in a fixed font (HUD digits, timestamps...)
+     * by comparing each glyph against known samples of the font.
+     *
+     * The glyphs of a line are found as connected components of a binary mask, where
+     * components that overlap horizontally (e.g. the dots of ':') form one glyph. Each
+     * glyph is scaled to a small bit cell and compared to the samples by the amount of
+     * differing bits, so a read takes microseconds rather than a tesseract pass.
+     *
+     * Samples are added from glyph sheets or learned from lines whose text is known,
+     * e.g. confident tesseract results, reads and learning are threadsafe. A learned
+     * glyph only becomes a sample once several lines agree on its character, so that
+     * a single misread does not teach the set a wrong character.
+     */
+    class glyph_set
+    {
+    public:
+        /**
+         * @brief The width and height of the bit cell that glyphs are scaled to.
+         */
+        static constexpr int CELL_SIZE = 16;
+
+        /**
+         * @brief The maximum amount of samples kept per character.
+         */
+        static constexpr size_t MAX_SAMPLES = 8;
+
+        /**
+         * @brief The amount of learned lines that have to agree on the character of
+         * a glyph before it becomes a sample.
+         */
+        static constexpr int MIN_AGREEING_READS = 3;
+
+        /**
+         * @brief Adds the glyphs of a sheet, a binary mask of a line of characters.
+         *
+         * @param sheet The binary (CV_8U) mask of the sheet.
+         * @param characters The characters on the sheet, spaces are ignored.
+         *
+         * @throws asapp_error If the glyphs on the sheet dont match the characters.
+         */
+        void add_sheet(const cv::Mat& sheet, std::string_view characters);
+
+        /**
+         * @brief Learns the glyphs of a line whose text is known.
+         *
+         * @param src The binary (CV_8U) mask of the line.
+         * @param text The text of the line, leading and trailing whitespace is ignored.
+         *
+         * @return True if the glyphs of the line matched the text, the glyphs are only
+         * added as samples once enough lines agreed on them.
+         */
+        bool learn(const cv::Mat& src, std::string_view text);
+
+        /**
+         * @brief Reads the text of a line.
+         *
+         * @param src The binary (CV_8U) mask of the line.
+         *
+         * @return The text of the line, std::nullopt if there are no glyphs in the
+         * line or no samples to compare them against. The confidence is 0 unless the
+         * set knows at least two characters.
+         */
+        [[nodiscard]] std::optional<glyph_read> read(const cv::Mat& src) const;
+
+        /**
+         * @brief Checks whether the set has samples of every given character.
+         */
+        [[nodiscard]] bool knows(std::string_view characters) const;
+
+    private:
+        using cell_t = std::array<uint64_t, CELL_SIZE * CELL_SIZE / 64>;
+
+        struct glyph
+        {
+            cv::Rect box;
+            cell_t cell;
+
+            // height, offset from the top of the line, width and the gap to the
+            // previous glyph relative to the height of the line, lost in the cell.
+            float height;
+            float top;
+            float width;
+            float gap;
+        };
+
+        struct sample
+        {
+            char character;
+            glyph features;
+        };
+
+        struct pending_sample : sample
+        {
+            // the amount of learned lines that read the glyph as the character.
+            int reads;
+        };
+
+        // the maximum amount of learned glyphs that wait for agreeing reads.
+        static constexpr size_t MAX_PENDING = 256;
+
+        [[nodiscard]] static std::vector<glyph> segment(const cv::Mat& src);
+
+        [[nodiscard]] static float distance(const glyph& a, const glyph& b);
+
+        bool add(const std::vector<glyph>& glyphs, std::string_view text, bool trusted);
+
+        /**
+         * @brief Records a learned read of a glyph as a character.
+         *
+         * @return True if enough reads agreed on the character of the glyph.
+         */
+        bool agrees(const glyph& g, char character);
+
+        mutable std::shared_mutex mutex_;
+        std::vector<sample> samples_;
+        std::vector<pending_sample> pending_;
+
+        // the widest gap between two glyphs of a word and the narrowest gap between
+        // two words that were seen, relative to the line height.
+        float max_glyph_gap_ = 0.f;
+        float min_space_gap_ = std::numeric_limits<float>::infinity();
+    };
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "asa/vision/ocr_engine_pool.h"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace asa::vision
+{
+    /**
+     * @brief A bounded cache of OCR results keyed by the content of the OCR input.
+     *
+     * The same pixels are often read over and over (tribelog rows that stay on screen,
+     * tooltips, notification counts), a cache hit costs a hash of the input instead of
+     * a tesseract pass. The least recently used result is evicted once full.
+     */
+    class ocr_cache
+    {
+    public:
+        /**
+         * @brief Creates an empty cache.
+         *
+         * @param t_capacity The maximum amount of results to keep, at least 1.
+         */
+        explicit ocr_cache(size_t t_capacity = 512);
+
+        /**
+         * @brief Computes the key of an OCR request.
+         *
+         * The raw bytes of the image are hashed, tesseract thresholds grayscale input
+         * itself so two images only share a key if every pixel value is the same.
+         *
+         * @param src The image that is to be read, may be a ROI.
+         * @param mode The page segmentation mode the image is read with.
+         * @param whitelist The character whitelist the image is read with.
+         */
+        [[nodiscard]] static uint64_t make_key(const cv::Mat& src,
+                                               tesseract::PageSegMode mode,
+                                               const char* whitelist);
+
+        /**
+         * @brief Gets the cached result of a key and marks it as recently used.
+         *
+         * @return The cached result, std::nullopt if the key is not cached.
+         */
+        [[nodiscard]] std::optional<ocr_result> get(uint64_t key);
+
+        /**
+         * @brief Caches the result of a key, evicting the least recently used result
+         * if the cache is full.
+         */
+        void put(uint64_t key, ocr_result result);
+
+        /**
+         * @brief Removes all cached results, the counters are kept.
+         */
+        void clear();
+
+        /**
+         * @brief Sets the maximum amount of results, evicting results if needed.
+         */
+        void set_capacity(size_t capacity);
+
+        [[nodiscard]] size_t get_size() const;
+
+        [[nodiscard]] uint64_t get_hits() const { return hits_; }
+
+        [[nodiscard]] uint64_t get_misses() const { return misses_; }
+
+    private:
+        using entry_t = std::pair<uint64_t, ocr_result>;
+
+        void evict();
+
+        size_t capacity_;
+
+        mutable std::mutex mutex_;
+
+        // most recently used at the front.
+        std::list<entry_t> entries_;
+        std::unordered_map<uint64_t, std::list<entry_t>::iterator> lookup_;
+
+        std::atomic<uint64_t> hits_{0};
+        std::atomic<uint64_t> misses_{0};
+    };
+
+    /**
+     * @brief Gets the OCR cache shared by the library.
+     */
+    [[nodiscard]] ocr_cache& get_ocr_cache();
+}
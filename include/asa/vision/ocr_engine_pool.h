@@ -0,0 +1,171 @@
+#pragma once
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <tesseract/publictypes.h>
+
+namespace tesseract
+{
+    class TessBaseAPI;
+}
+
+namespace asa::vision
+{
+    /**
+     * @brief The text read from an image and how confident the read is.
+     */
+    struct ocr_result
+    {
+        std::string text;
+
+        // the mean confidence of the words of the text, 0 - 100.
+        int confidence;
+    };
+
+    /**
+     * @brief A tesseract engine together with the settings it was last used with.
+     *
+     * Changing the page segmentation mode or the whitelist of an engine is not free,
+     * so they are only passed to tesseract when they differ from the last request.
+     */
+    class ocr_engine
+    {
+    public:
+        /**
+         * @brief Creates and initializes an engine.
+         *
+         * @throws tesseract_not_initialized If the engine could not be initialized.
+         */
+        ocr_engine(const std::filesystem::path& tessdata, const std::string& language);
+
+        ~ocr_engine();
+
+        ocr_engine(const ocr_engine&) = delete;
+
+        ocr_engine& operator=(const ocr_engine&) = delete;
+
+        /**
+         * @brief Extracts the text from an image.
+         *
+         * @param src The image to extract the text from, preprocessing should be done
+         * before.
+         * @param mode The page segmentation mode to use for the text extraction.
+         * @param whitelist The character whitelist to use.
+         */
+        [[nodiscard]] ocr_result recognize(const cv::Mat& src,
+                                           tesseract::PageSegMode mode,
+                                           const char* whitelist);
+
+    private:
+        std::unique_ptr<tesseract::TessBaseAPI> api_;
+
+        std::optional<tesseract::PageSegMode> mode_;
+        std::string whitelist_;
+    };
+
+    /**
+     * @brief A pool of tesseract engines so that OCR on different threads does not
+     * have to wait for a single engine.
+     *
+     * Engines are created lazily when all existing engines are in use, up to the
+     * maximum amount of engines. Once the maximum is reached, acquiring an engine
+     * waits for another thread to release one.
+     */
+    class ocr_engine_pool
+    {
+    public:
+        /**
+         * @brief An engine acquired from the pool, returned to the pool on destruction.
+         */
+        class lease
+        {
+        public:
+            lease(ocr_engine_pool* t_pool, std::unique_ptr<ocr_engine> t_engine);
+
+            ~lease();
+
+            lease(lease&&) noexcept = default;
+
+            lease& operator=(lease&&) = delete;
+
+            lease(const lease&) = delete;
+
+            lease& operator=(const lease&) = delete;
+
+            ocr_engine* operator->() const { return engine_.get(); }
+
+            ocr_engine& operator*() const { return *engine_; }
+
+        private:
+            ocr_engine_pool* pool_;
+            std::unique_ptr<ocr_engine> engine_;
+        };
+
+        /**
+         * @brief Creates an empty pool, engines are created when first needed.
+         *
+         * @param t_tessdata The path to the tessdata directory.
+         * @param t_language The language to initialize the engines with.
+         * @param t_max_engines The maximum amount of engines, at least 1.
+         */
+        ocr_engine_pool(std::filesystem::path t_tessdata, std::string t_language,
+                        size_t t_max_engines);
+
+        ocr_engine_pool(const ocr_engine_pool&) = delete;
+
+        ocr_engine_pool& operator=(const ocr_engine_pool&) = delete;
+
+        /**
+         * @brief Acquires an idle engine, creating one if none is idle and the pool
+         * has not reached its maximum size yet.
+         *
+         * @throws tesseract_not_initialized If a new engine could not be initialized.
+         */
+        [[nodiscard]] lease acquire();
+
+        /**
+         * @brief Creates engines until at least the given amount exist.
+         *
+         * @param num_engines The amount of engines to have ready, capped at the maximum.
+         *
+         * @throws tesseract_not_initialized If an engine could not be initialized.
+         */
+        void reserve(size_t num_engines);
+
+        /**
+         * @brief Sets the maximum amount of engines, existing engines are kept.
+         */
+        void set_max_engines(size_t max_engines);
+
+        [[nodiscard]] size_t get_max_engines() const;
+
+        /**
+         * @brief Gets the amount of engines that have been created so far.
+         */
+        [[nodiscard]] size_t get_num_engines() const;
+
+    private:
+        void release(std::unique_ptr<ocr_engine> engine);
+
+        std::filesystem::path tessdata_;
+        std::string language_;
+        size_t max_engines_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable available_;
+        std::vector<std::unique_ptr<ocr_engine> > idle_;
+
+        // engines that exist (or are being created) including the ones leased out.
+        size_t num_engines_ = 0;
+    };
+
+    /**
+     * @brief Gets the engine pool shared by the library, sized to the hardware threads.
+     */
+    [[nodiscard]] ocr_engine_pool& get_ocr_engine_pool();
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include "asa/vision/color_count.h"
+
+#include <variant>
+#include <vector>
+#include <opencv2/core.hpp>
+
+namespace asa::vision
+{
+    /**
+     * @brief The preprocessing of an image before it is read, built once per call site
+     * from stages that run in the order they were added.
+     *
+     * Intermediate results are written to buffers that each thread keeps across runs,
+     * so running a pipeline allocates at most its output.
+     *
+     * @code
+     * static const auto pipeline = ocr_pipeline()
+     *         .isolate({255, 255, 255}, 50).crop_to_content().upscale(2).pad(8);
+     * const cv::Mat mask = pipeline.run(image);
+     * @endcode
+     */
+    class ocr_pipeline
+    {
+    public:
+        /**
+         * @brief Masks the pixels of a color (BGR input to binary mask).
+         *
+         * Consecutive isolate stages are run as a single pass that keeps the pixels
+         * of any of their colors, the same as OR-ing their masks.
+         *
+         * @param color The RGB color to isolate, see `utility::mask`.
+         * @param variance The variance allowed per channel.
+         */
+        ocr_pipeline& isolate(const cv::Vec3b& color, int variance);
+
+        /**
+         * @brief Sets every pixel brighter than the threshold and clears the others,
+         * color input is converted to grayscale first.
+         */
+        ocr_pipeline& binarize(int threshold);
+
+        /**
+         * @brief Scales the image up by an integer factor without interpolation.
+         */
+        ocr_pipeline& upscale(int factor);
+
+        /**
+         * @brief Crops the image to the bounding box of its set pixels, an image
+         * without set pixels is left as is.
+         */
+        ocr_pipeline& crop_to_content();
+
+        /**
+         * @brief Pads the image with a border of unset pixels on every side.
+         */
+        ocr_pipeline& pad(int pixels);
+
+        /**
+         * @brief Runs the stages on an image.
+         *
+         * @param src The image to process, may be a ROI.
+         * @param dst The image to write the result to, must not share data with src.
+         */
+        void run(const cv::Mat& src, cv::Mat& dst) const;
+
+        /**
+         * @brief Runs the stages on an image.
+         *
+         * @param src The image to process, may be a ROI.
+         *
+         * @return The result in a newly allocated image.
+         */
+        [[nodiscard]] cv::Mat run(const cv::Mat& src) const;
+
+    private:
+        struct isolate_stage
+        {
+            std::vector<color_range> ranges;
+        };
+
+        struct binarize_stage
+        {
+            int threshold;
+        };
+
+        struct upscale_stage
+        {
+            int factor;
+        };
+
+        struct crop_stage {};
+
+        struct pad_stage
+        {
+            int pixels;
+        };
+
+        using stage_t = std::variant<isolate_stage, binarize_stage, upscale_stage,
+                                     crop_stage, pad_stage>;
+
+        std::vector<stage_t> stages_;
+    };
+}
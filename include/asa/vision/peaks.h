@@ -0,0 +1,42 @@
+#pragma once
+#include <limits>
+#include <vector>
+#include <opencv2/core.hpp>
+
+namespace asa::vision
+{
+    /**
+     * @brief A location a template matched at along with the score of the match.
+     */
+    struct scored_match
+    {
+        cv::Rect rect;
+        float score;
+    };
+
+    /**
+     * @brief Extracts all matches from the scores of a template match in one pass.
+     *
+     * Every local maximum of the scores that reaches the threshold is a candidate,
+     * candidates overlapping a better candidate are then suppressed.
+     *
+     * @param scores The CV_32FC1 scores of the match, higher is better.
+     * @param size The size of the template that was matched.
+     * @param threshold The minimum score for a match to be considered.
+     * @param max_matches The maximum amount of matches to return.
+     * @param max_overlap The intersection over union above which two matches are the same.
+     *
+     * @return The matches sorted by their score, best match first.
+     */
+    [[nodiscard]] std::vector<scored_match> find_peaks(
+        const cv::Mat& scores, const cv::Size& size, float threshold,
+        size_t max_matches = std::numeric_limits<size_t>::max(),
+        float max_overlap = 0.3f);
+
+    /**
+     * @brief Sorts matches by their score and drops every match that overlaps a better
+     * one by more than the given intersection over union (non-maximum suppression).
+     */
+    void suppress_overlapping(std::vector<scored_match>& matches,
+                              float max_overlap = 0.3f);
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <deque>
+#include <mutex>
+#include <opencv2/core.hpp>
+
+namespace asa::vision
+{
+    /**
+     * @brief Computes the 64 bit difference hash (dHash) of an image.
+     *
+     * The image is reduced to 9x8 grayscale pixels and every bit is whether a pixel is
+     * (noticeably) brighter than its right neighbour, so the hash survives slight
+     * changes in brightness and scale but not changes in content.
+     *
+     * @param src The BGR, BGRA or grayscale image to hash, may be a ROI.
+     */
+    [[nodiscard]] uint64_t dhash(const cv::Mat& src);
+
+    /**
+     * @brief Mixes a word into a 64 bit hash, multiply-xorshift as used by splitmix64.
+     */
+    [[nodiscard]] uint64_t mix_hash(uint64_t hash, uint64_t word);
+
+    /**
+     * @brief Computes a 64 bit hash of the exact content of an image, its size, type
+     * and the raw bytes of every pixel.
+     *
+     * @param src The image to hash, may be a ROI.
+     */
+    [[nodiscard]] uint64_t content_hash(const cv::Mat& src);
+
+    /**
+     * @brief Gets the amount of bits that differ between two hashes.
+     */
+    [[nodiscard]] int hamming_distance(uint64_t a, uint64_t b);
+
+    /**
+     * @brief The content hashes of the most recent images that were seen, to tell
+     * whether an image was seen before without looking at its content again.
+     *
+     * Images are compared by `content_hash`, an image that changed in a single pixel
+     * is not known even if its difference hash did not change.
+     */
+    class fingerprint_set
+    {
+    public:
+        /**
+         * @param t_capacity The amount of hashes to remember, older ones are dropped.
+         */
+        explicit fingerprint_set(size_t t_capacity);
+
+        /**
+         * @brief Checks whether an image with the content hash has been seen.
+         */
+        [[nodiscard]] bool contains(uint64_t hash) const;
+
+        /**
+         * @brief Remembers a content hash, dropping the oldest one if at capacity.
+         *
+         * @return True if the hash was new, false if it was already known.
+         */
+        bool insert(uint64_t hash);
+
+        void clear();
+
+        [[nodiscard]] size_t get_size() const;
+
+    private:
+        size_t capacity_;
+
+        mutable std::mutex mutex_;
+        std::deque<uint64_t> hashes_;
+    };
+}
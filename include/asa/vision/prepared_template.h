@@ -0,0 +1,115 @@
+#pragma once
+#include <vector>
+#include <opencv2/core.hpp>
+
+namespace asa::vision
+{
+    /**
+     * @brief Controls coarse-to-fine matching of a prepared template.
+     *
+     * The source is first matched at a reduced scale, only the best candidates of
+     * that pass are then matched again at full scale within a small window. Lower
+     * levels and a higher slack or more candidates trade speed for accuracy.
+     */
+    struct pyramid_options
+    {
+        /**
+         * @brief The amount of half-scale levels, 1 matches at 1/2 scale, 2 at 1/4.
+         * A level of 0 disables coarse-to-fine matching.
+         */
+        int levels = 0;
+
+        /**
+         * @brief How far below the threshold a coarse match may be to still be refined.
+         */
+        float slack = 0.15f;
+
+        /**
+         * @brief The maximum amount of coarse candidates refined to locate the best match.
+         */
+        int max_candidates = 4;
+    };
+
+    /**
+     * @brief A template with everything that matching it requires computed once.
+     *
+     * Holds the BGR and grayscale variants of the template and its mask, the mean and
+     * standard deviation of the template and optionally downscaled pyramid levels so
+     * that repeated matches of the same template do not redo any of that work.
+     *
+     * @remark A mask that does not exclude any pixel is dropped, masked matching is
+     * considerably slower than unmasked matching but yields the same result then.
+     * @remark If pyramid levels are prepared, matches against sources that are large
+     * enough are made coarse-to-fine, see `pyramid_options`.
+     */
+    class prepared_template
+    {
+    public:
+        /**
+         * @brief Prepares a template for matching.
+         *
+         * @param t_template The BGR (or BGRA) template to prepare.
+         * @param t_mask [OPTIONAL] A CV_8UC1 mask to exclude an area of the template.
+         * @param t_pyramid [OPTIONAL] The coarse-to-fine matching of the template.
+         */
+        explicit prepared_template(const cv::Mat& t_template, const cv::Mat& t_mask = {},
+                                   const pyramid_options& t_pyramid = {});
+
+        /**
+         * @brief Gets the template image at a pyramid level.
+         *
+         * @param grayscale Whether to get the single-channel variant of the template.
+         * @param level The pyramid level, 0 is the template at full scale.
+         */
+        [[nodiscard]] const cv::Mat& get_image(bool grayscale, int level = 0) const;
+
+        /**
+         * @brief Gets the mask of the template at a pyramid level, empty if unmasked.
+         */
+        [[nodiscard]] const cv::Mat& get_mask(int level = 0) const;
+
+        [[nodiscard]] bool has_mask() const { return !levels_.front().mask.empty(); }
+
+        /**
+         * @brief Gets the size of the template at full scale.
+         */
+        [[nodiscard]] cv::Size get_size() const { return levels_.front().bgr.size(); }
+
+        /**
+         * @brief Gets the amount of downscaled levels that were prepared, may be less
+         * than requested if the template became too small.
+         */
+        [[nodiscard]] int get_pyramid_levels() const
+        {
+            return static_cast<int>(levels_.size()) - 1;
+        }
+
+        [[nodiscard]] const pyramid_options& get_pyramid_options() const
+        {
+            return pyramid_;
+        }
+
+        /**
+         * @brief Gets the per-channel mean of the (unmasked pixels of the) template.
+         */
+        [[nodiscard]] const cv::Scalar& get_mean() const { return mean_; }
+
+        /**
+         * @brief Gets the per-channel standard deviation of the template.
+         */
+        [[nodiscard]] const cv::Scalar& get_stddev() const { return stddev_; }
+
+    private:
+        struct level
+        {
+            cv::Mat bgr;
+            cv::Mat gray;
+            cv::Mat mask;
+        };
+
+        std::vector<level> levels_;
+        pyramid_options pyramid_;
+        cv::Scalar mean_;
+        cv::Scalar stddev_;
+    };
+}
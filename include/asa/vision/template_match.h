@@ -0,0 +1,111 @@
+#pragma once
+#include "asa/vision/peaks.h"
+#include "asa/vision/prepared_template.h"
+
+#include <span>
+#include <vector>
+#include <opencv2/imgproc.hpp>
+
+namespace asa::vision
+{
+    /**
+     * @brief A source image prepared once to be matched against by many templates.
+     *
+     * Holds the (grayscale) image and the half-scale levels that templates prepared
+     * with pyramid levels are matched against first.
+     */
+    class prepared_source
+    {
+    public:
+        /**
+         * @brief Prepares a source image for matching.
+         *
+         * @param t_source The BGR (or BGRA) image to prepare, may be a ROI.
+         * @param t_grayscale Whether templates are matched against a grayscale image.
+         * @param t_pyramid_levels The amount of half-scale levels to prepare.
+         */
+        explicit prepared_source(const cv::Mat& t_source, bool t_grayscale = false,
+                                 int t_pyramid_levels = 0);
+
+        /**
+         * @brief Gets the image at a pyramid level, 0 is the source at full scale.
+         */
+        [[nodiscard]] const cv::Mat& get_image(int level = 0) const;
+
+        [[nodiscard]] int get_pyramid_levels() const
+        {
+            return static_cast<int>(levels_.size()) - 1;
+        }
+
+        [[nodiscard]] bool is_grayscale() const { return grayscale_; }
+
+    private:
+        std::vector<cv::Mat> levels_;
+        bool grayscale_;
+    };
+
+    /**
+     * @brief Converts an image to a single channel image, if it isn't one already.
+     */
+    [[nodiscard]] cv::Mat to_gray(const cv::Mat& src);
+
+    /**
+     * @brief Matches a template against a source image.
+     *
+     * @return The CV_32FC1 scores of the match, for the squared difference modes the
+     * scores are inverted (1 - difference) so that a higher score is always better.
+     */
+    [[nodiscard]] cv::Mat match_scores(const cv::Mat& source, const cv::Mat& _template,
+                                       const cv::Mat& mask, int mode);
+
+    /**
+     * @brief Gets the amount of pyramid levels to match a template coarse-to-fine with
+     * against a source of the given size, 0 if it is not possible or worth it.
+     */
+    [[nodiscard]] int get_usable_pyramid_levels(const prepared_template& _template,
+                                                const cv::Size& source);
+
+    /**
+     * @brief Finds the best match of a prepared template within a prepared source.
+     *
+     * @param source The source to find the template in.
+     * @param _template The template to find.
+     * @param threshold The score a match has to reach, used to prune coarse candidates.
+     * @param mode The mode to match the template with.
+     *
+     * @return The best match, its rect is empty if the template could not be matched.
+     */
+    [[nodiscard]] scored_match best_match(const prepared_source& source,
+                                          const prepared_template& _template,
+                                          float threshold,
+                                          int mode = cv::TM_CCOEFF_NORMED);
+
+    /**
+     * @brief Finds all matches of a prepared template within a prepared source.
+     *
+     * @return The matches that reached the threshold, best match first.
+     */
+    [[nodiscard]] std::vector<scored_match> all_matches(
+        const prepared_source& source, const prepared_template& _template,
+        float threshold);
+
+    /**
+     * @brief Matches many templates against the same source image.
+     *
+     * The source is converted and downscaled once for all templates, the templates
+     * are then distributed over the library thread pool.
+     *
+     * @param source The BGR image to match the templates against.
+     * @param templates The templates to match.
+     * @param threshold The score a match has to reach, used to prune coarse candidates.
+     * @param grayscale Whether to match the single-channel variants of the images.
+     * @param mode The mode to match the templates with.
+     * @param max_threads The maximum amount of threads to use, 0 for no limit.
+     *
+     * @return The best match of every template, in the order of the templates.
+     */
+    [[nodiscard]] std::vector<scored_match> match_batch(
+        const cv::Mat& source, std::span<const prepared_template* const> templates,
+        float threshold = 0.7f, bool grayscale = false, int mode = cv::TM_CCOEFF_NORMED,
+        unsigned int max_threads = 0);
+}
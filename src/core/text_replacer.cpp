@@ -0,0 +1,121 @@
+#include "asa/core/text_replacer.h"
+
+#include <queue>
+
+namespace asa
+{
+    text_replacer::text_replacer(const replacements_t& t_replacements)
+    {
+        for (const auto& [pattern, replacement]: t_replacements) {
+            for (const char c: pattern) {
+                uint16_t& cls = classes_[static_cast<uint8_t>(c)];
+                if (cls == 0) { cls = static_cast<uint16_t>(num_classes_++); }
+            }
+        }
+
+        // build the trie, -1 marks a missing edge until the automaton is completed.
+        transitions_.assign(num_classes_, -1);
+        depths_.push_back(0);
+        outputs_.emplace_back();
+
+        for (const auto& [pattern, replacement]: t_replacements) {
+            if (pattern.empty()) { continue; }
+
+            int32_t state = 0;
+            for (const char c: pattern) {
+                const size_t edge = state * num_classes_ +
+                                    classes_[static_cast<uint8_t>(c)];
+                if (transitions_[edge] == -1) {
+                    transitions_[edge] = static_cast<int32_t>(depths_.size());
+                    transitions_.resize(transitions_.size() + num_classes_, -1);
+                    depths_.push_back(depths_[state] + 1);
+                    outputs_.emplace_back();
+                }
+                state = transitions_[edge];
+            }
+            outputs_[state] = {pattern.size(), replacements_.size()};
+            replacements_.push_back(replacement);
+        }
+
+        // turn the trie into the automaton breadth first, the missing edges of a state
+        // are those of its failure state, which is always at a lower depth.
+        std::vector<int32_t> failure(depths_.size(), 0);
+        std::queue<int32_t> pending;
+        for (size_t c = 0; c < num_classes_; c++) {
+            int32_t& child = transitions_[c];
+            if (child == -1) { child = 0; }
+            else { pending.push(child); }
+        }
+
+        while (!pending.empty()) {
+            const int32_t state = pending.front();
+            pending.pop();
+
+            // a pattern ending at the state is longer than any of its failure state.
+            if (outputs_[state].length == 0) {
+                outputs_[state] = outputs_[failure[state]];
+            }
+
+            for (size_t c = 0; c < num_classes_; c++) {
+                int32_t& child = transitions_[state * num_classes_ + c];
+                const int32_t fallback = transitions_[failure[state] * num_classes_ + c];
+                if (child == -1) {
+                    child = fallback;
+                } else {
+                    failure[child] = fallback;
+                    pending.push(child);
+                }
+            }
+        }
+    }
+
+    std::string text_replacer::replace(const std::string_view text,
+                                       size_t* replaced) const
+    {
+        std::string out;
+        out.reserve(text.size());
+
+        size_t num_replaced = 0;
+        size_t emitted = 0;
+        size_t i = 0;
+        int32_t state = 0;
+
+        // the leftmost (then longest) match so far, only replaced once no match that
+        // starts at or before it can be found anymore.
+        bool has_match = false;
+        size_t match_start = 0;
+        output match;
+
+        while (i < text.size() || has_match) {
+            if (i < text.size()) {
+                state = next(state, text[i++]);
+
+                if (const output& found = outputs_[state]; found.length) {
+                    const size_t start = i - found.length;
+                    if (!has_match || start < match_start ||
+                        (start == match_start && found.length > match.length)) {
+                        has_match = true;
+                        match_start = start;
+                        match = found;
+                    }
+                }
+
+                // the current state still covers the start of the match, it may grow.
+                if (!has_match || i - depths_[state] <= match_start) { continue; }
+            }
+
+            out.append(text, emitted, match_start - emitted);
+            out += replacements_[match.replacement];
+            num_replaced++;
+
+            // search the rest of the text again from the end of the replaced match.
+            emitted = i = match_start + match.length;
+            state = 0;
+            has_match = false;
+        }
+        out.append(text, emitted);
+
+        if (replaced) { *replaced = num_replaced; }
+        return out;
+    }
+}
@@ -0,0 +1,174 @@
+#include "asa/core/thread_pool.h"
+#include "asa/core/logging.h"
+
+namespace asa
+{
+    namespace
+    {
+        // the pool and the index of the worker that the current thread is, if any.
+        thread_local const thread_pool* current_pool = nullptr;
+        thread_local size_t current_worker = 0;
+    }
+
+    thread_pool::thread_pool(const size_t t_num_threads)
+    {
+        const size_t num_threads = std::max<size_t>(t_num_threads, 1);
+        for (size_t i = 0; i < num_threads; i++) {
+            queues_.push_back(std::make_unique<worker_queue>());
+        }
+
+        threads_.reserve(num_threads);
+        for (size_t i = 0; i < num_threads; i++) {
+            threads_.emplace_back(&thread_pool::run, this, i);
+        }
+    }
+
+    thread_pool::~thread_pool()
+    {
+        {
+            std::lock_guard lock(wake_mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+
+        for (auto& thread: threads_) { thread.join(); }
+    }
+
+    void thread_pool::post(std::function<void()> fn, const TaskPriority priority)
+    {
+        push([fn = std::move(fn)]() -> void {
+            try {
+                fn();
+            } catch (const std::exception& e) {
+                get_logger()->error("Posted task failed: {}", e.what());
+            }
+        }, priority);
+    }
+
+    void thread_pool::parallel_for(const size_t begin, const size_t end,
+                                   const std::function<void(size_t)>& fn,
+                                   const TaskPriority priority, const size_t max_threads)
+    {
+        if (begin >= end) { return; }
+
+        struct state
+        {
+            std::atomic<size_t> next;
+            size_t end;
+            std::atomic<size_t> remaining;
+            const std::function<void(size_t)>* fn;
+
+            std::mutex mutex;
+            std::condition_variable done;
+            std::exception_ptr error;
+        };
+
+        // helpers may only get to run once all indices are done, so they must not
+        // touch anything but the shared state unless they claimed an index.
+        const auto shared = std::make_shared<state>();
+        shared->next = begin;
+        shared->end = end;
+        shared->remaining = end - begin;
+        shared->fn = &fn;
+
+        auto work = [](state& s) -> void {
+            for (size_t i = s.next++; i < s.end; i = s.next++) {
+                try {
+                    (*s.fn)(i);
+                } catch (...) {
+                    std::lock_guard lock(s.mutex);
+                    if (!s.error) { s.error = std::current_exception(); }
+                }
+
+                if (--s.remaining == 0) {
+                    std::lock_guard lock(s.mutex);
+                    s.done.notify_all();
+                }
+            }
+        };
+
+        size_t helpers = std::min(end - begin - 1, threads_.size());
+        if (max_threads) { helpers = std::min(helpers, max_threads - 1); }
+        for (size_t i = 0; i < helpers; i++) {
+            push([shared, work]() -> void { work(*shared); }, priority);
+        }
+
+        work(*shared);
+
+        std::unique_lock lock(shared->mutex);
+        shared->done.wait(lock, [&shared]() -> bool { return shared->remaining == 0; });
+        if (shared->error) { std::rethrow_exception(shared->error); }
+    }
+
+    void thread_pool::push(task_t task, const TaskPriority priority)
+    {
+        // a worker keeps the tasks it submits, they are likely to use what is cached.
+        const size_t index = current_pool == this
+                                 ? current_worker
+                                 : next_queue_++ % queues_.size();
+        {
+            worker_queue& queue = *queues_[index];
+            std::lock_guard lock(queue.mutex);
+            queue.tasks[static_cast<size_t>(priority)].push_back(std::move(task));
+        }
+        {
+            std::lock_guard lock(wake_mutex_);
+            ++queued_;
+        }
+        wake_.notify_one();
+    }
+
+    bool thread_pool::try_pop(const size_t worker, task_t& out)
+    {
+        const size_t num_queues = queues_.size();
+        for (size_t p = NUM_PRIORITIES; p-- > 0;) {
+            // newest task of our own queue first, then the oldest of any other queue.
+            {
+                worker_queue& own = *queues_[worker];
+                std::lock_guard lock(own.mutex);
+                if (!own.tasks[p].empty()) {
+                    out = std::move(own.tasks[p].back());
+                    own.tasks[p].pop_back();
+                    --queued_;
+                    return true;
+                }
+            }
+
+            for (size_t i = 1; i < num_queues; i++) {
+                worker_queue& other = *queues_[(worker + i) % num_queues];
+                std::lock_guard lock(other.mutex);
+                if (!other.tasks[p].empty()) {
+                    out = std::move(other.tasks[p].front());
+                    other.tasks[p].pop_front();
+                    --queued_;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void thread_pool::run(const size_t worker)
+    {
+        current_pool = this;
+        current_worker = worker;
+
+        while (true) {
+            if (task_t task; try_pop(worker, task)) {
+                task();
+                continue;
+            }
+
+            std::unique_lock lock(wake_mutex_);
+            wake_.wait(lock, [this]() -> bool { return stopping_ || queued_ > 0; });
+            if (stopping_ && queued_ == 0) { return; }
+        }
+    }
+
+    thread_pool& get_thread_pool()
+    {
+        static auto instance = new thread_pool(
+            std::max(1u, std::thread::hardware_concurrency()));
+        return *instance;
+    }
+}
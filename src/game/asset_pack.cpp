@@ -0,0 +1,241 @@
+#include "asa/game/asset_pack.h"
+#include "asa/utility.h"
+#include "asa/core/logging.h"
+#include "asa/game/exceptions.h"
+
+#include <atomic>
+#include <cstring>
+#include <format>
+#include <memory>
+#include <opencv2/imgcodecs.hpp>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace asa
+{
+    namespace
+    {
+        constexpr char MAGIC[8] = {'A', 'S', 'A', 'P', 'A', 'C', 'K', '\x01'};
+
+        // the magic, the amount of entries and 4 reserved bytes.
+        constexpr size_t HEADER_SIZE = 16;
+
+        // offset, size, rows, cols, type, encoding, reserved and the name length.
+        constexpr size_t ENTRY_SIZE = 8 + 8 + 4 + 4 + 4 + 1 + 1 + 2;
+
+        constexpr auto PACK_NAME = "assets.pack";
+
+        // the pack set through set_asset_pack_path, the one next to the executable if
+        // empty.
+        std::filesystem::path pack_path;
+        std::unique_ptr<asset_pack> pack;
+        std::mutex pack_mutex;
+
+        // the open pack, so that requesting an asset does not have to take the lock.
+        std::atomic<const asset_pack*> open_pack = nullptr;
+
+        template<typename T>
+        T read(const uint8_t* src)
+        {
+            T ret;
+            std::memcpy(&ret, src, sizeof(T));
+            return ret;
+        }
+    }
+
+    asset_pack::asset_pack(std::filesystem::path t_path) : path_(std::move(t_path))
+    {
+        map_file();
+        try {
+            read_index();
+        } catch (...) {
+            unmap_file();
+            throw;
+        }
+    }
+
+    asset_pack::~asset_pack()
+    {
+        unmap_file();
+    }
+
+    const cv::Mat& asset_pack::get(const std::string_view name) const
+    {
+        const entry& e = find(name);
+        if (e.encoding == DATA) { throw asset_not_found(name); }
+
+        std::call_once(e.decoded, [&e] {
+            if (e.encoding == RAW) {
+                // the mapping is copy on write, a mat that is written to despite the
+                // contract can not fault or change the file.
+                e.mat = cv::Mat(e.rows, e.cols, e.type, const_cast<uint8_t*>(e.data));
+            } else {
+                const cv::Mat buffer(1, static_cast<int>(e.size), CV_8UC1,
+                                     const_cast<uint8_t*>(e.data));
+                e.mat = cv::imdecode(buffer, cv::IMREAD_UNCHANGED);
+            }
+        });
+        return e.mat;
+    }
+
+    std::string_view asset_pack::get_data(const std::string_view name) const
+    {
+        const entry& e = find(name);
+        if (e.encoding != DATA) { throw asset_not_found(name); }
+        return {reinterpret_cast<const char*>(e.data), e.size};
+    }
+
+    bool asset_pack::contains(const std::string_view name) const
+    {
+        return entries_.contains(name);
+    }
+
+    const asset_pack::entry& asset_pack::find(const std::string_view name) const
+    {
+        const auto it = entries_.find(name);
+        if (it == entries_.end()) { throw asset_not_found(name); }
+        return it->second;
+    }
+
+    void asset_pack::read_index()
+    {
+        if (size_ < HEADER_SIZE || std::memcmp(data_, MAGIC, sizeof(MAGIC)) != 0) {
+            throw asset_pack_error(path_, "not an asset pack");
+        }
+
+        const auto count = read<uint32_t>(data_ + sizeof(MAGIC));
+        size_t pos = HEADER_SIZE;
+        for (uint32_t i = 0; i < count; i++) {
+            if (pos + ENTRY_SIZE > size_) { throw asset_pack_error(path_, "truncated"); }
+
+            const auto offset = read<uint64_t>(data_ + pos);
+            const auto blob_size = read<uint64_t>(data_ + pos + 8);
+            const auto name_size = read<uint16_t>(data_ + pos + 30);
+            if (pos + ENTRY_SIZE + name_size > size_ || offset > size_ ||
+                blob_size > size_ - offset) {
+                throw asset_pack_error(path_, "truncated");
+            }
+
+            const std::string_view name(
+                reinterpret_cast<const char*>(data_ + pos + ENTRY_SIZE), name_size);
+            entry& e = entries_[std::string(name)];
+            e.rows = read<int32_t>(data_ + pos + 16);
+            e.cols = read<int32_t>(data_ + pos + 20);
+            e.type = read<int32_t>(data_ + pos + 24);
+            e.encoding = static_cast<blob_encoding>(data_[pos + 28]);
+            e.data = data_ + offset;
+            e.size = blob_size;
+
+            if (e.encoding == RAW && static_cast<size_t>(e.rows) * e.cols *
+                CV_ELEM_SIZE(e.type) != e.size) {
+                throw asset_pack_error(path_, std::format("corrupt asset '{}'", name));
+            }
+            pos += ENTRY_SIZE + name_size;
+        }
+        get_logger()->info("Loaded {} assets from '{}'.", entries_.size(),
+                           path_.string());
+    }
+
+#ifdef _WIN32
+    void asset_pack::map_file()
+    {
+        file_ = CreateFileW(path_.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            file_ = nullptr;
+            throw asset_pack_error(path_, "could not open the file");
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) {
+            unmap_file();
+            throw asset_pack_error(path_, "could not read the file size");
+        }
+        size_ = static_cast<size_t>(size.QuadPart);
+
+        mapping_ = CreateFileMappingW(file_, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (mapping_) { data_ = static_cast<const uint8_t*>(
+            MapViewOfFile(mapping_, FILE_MAP_COPY, 0, 0, 0)); }
+        if (!data_) {
+            unmap_file();
+            throw asset_pack_error(path_, "could not map the file");
+        }
+    }
+
+    void asset_pack::unmap_file()
+    {
+        if (data_) { UnmapViewOfFile(data_); }
+        if (mapping_) { CloseHandle(mapping_); }
+        if (file_) { CloseHandle(file_); }
+        data_ = nullptr;
+        mapping_ = nullptr;
+        file_ = nullptr;
+    }
+#else
+    void asset_pack::map_file()
+    {
+        const int fd = open(path_.c_str(), O_RDONLY);
+        if (fd < 0) { throw asset_pack_error(path_, "could not open the file"); }
+
+        struct stat info{};
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            close(fd);
+            throw asset_pack_error(path_, "could not read the file size");
+        }
+        size_ = static_cast<size_t>(info.st_size);
+
+        void* data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) {
+            throw asset_pack_error(path_, "could not map the file");
+        }
+        data_ = static_cast<const uint8_t*>(data);
+    }
+
+    void asset_pack::unmap_file()
+    {
+        if (data_) { munmap(const_cast<uint8_t*>(data_), size_); }
+        data_ = nullptr;
+    }
+#endif
+
+    void set_asset_pack_path(std::filesystem::path path)
+    {
+        std::scoped_lock lock(pack_mutex);
+        if (pack) {
+            get_logger()->warn("Asset pack '{}' is already open, ignoring '{}'.",
+                               pack->get_path().string(), path.string());
+            return;
+        }
+        pack_path = std::move(path);
+    }
+
+    const asset_pack& get_asset_pack()
+    {
+        if (const asset_pack* current = open_pack.load(std::memory_order_acquire)) {
+            return *current;
+        }
+
+        std::scoped_lock lock(pack_mutex);
+        if (!pack) {
+            if (pack_path.empty()) {
+                pack_path = utility::get_executable_directory() / PACK_NAME;
+            }
+            pack = std::make_unique<asset_pack>(pack_path);
+            open_pack.store(pack.get(), std::memory_order_release);
+        }
+        return *pack;
+    }
+
+    const cv::Mat& asset(const std::string_view name)
+    {
+        return get_asset_pack().get(name);
+    }
+}
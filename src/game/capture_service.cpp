@@ -0,0 +1,137 @@
+#include "asa/game/capture_service.h"
+#include "asa/core/logging.h"
+
+namespace asa
+{
+    capture_service::capture_service(const size_t t_capacity)
+        : capacity_(std::max<size_t>(t_capacity, 1)),
+          ring_(std::make_unique<slot[]>(capacity_)) {}
+
+    capture_service::~capture_service()
+    {
+        stop();
+    }
+
+    void capture_service::start(const std::chrono::milliseconds interval)
+    {
+        if (running_.exchange(true)) { return; }
+
+        interval_ = interval;
+        thread_ = std::thread(&capture_service::run, this);
+        get_logger()->info("Capture service started ({} interval).", interval.count());
+    }
+
+    void capture_service::stop()
+    {
+        if (!running_.exchange(false)) { return; }
+
+        if (thread_.joinable()) { thread_.join(); }
+        signal_.notify_all();
+        get_logger()->info("Capture service stopped.");
+    }
+
+    frame_ptr capture_service::latest() const
+    {
+        while (true) {
+            const uint64_t head = head_.load(std::memory_order_acquire);
+            if (head == 0) { return nullptr; }
+
+            // only fails if the slot was reused since, a newer frame is ready then.
+            if (frame_ptr frame = read(head - 1)) { return frame; }
+        }
+    }
+
+    frame_ptr capture_service::wait_newer(const uint64_t sequence,
+                                          const std::chrono::milliseconds timeout) const
+    {
+        if (frame_ptr frame = latest(); frame && frame->sequence > sequence) {
+            return frame;
+        }
+
+        frame_ptr newer = nullptr;
+        std::unique_lock lock(signal_mutex_);
+        signal_.wait_for(lock, timeout, [this, sequence, &newer]() -> bool {
+            newer = latest();
+            return !running_ || (newer && newer->sequence > sequence);
+        });
+        return (newer && newer->sequence > sequence) ? newer : nullptr;
+    }
+
+    std::vector<frame_ptr> capture_service::history(
+        const std::chrono::milliseconds max_age) const
+    {
+        std::vector<frame_ptr> ret;
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        const uint64_t oldest = head > capacity_ ? head - capacity_ : 0;
+
+        for (uint64_t i = head; i > oldest; i--) {
+            // the slot may have been reused for a newer frame while we iterated.
+            frame_ptr frame = read(i - 1);
+            if (!frame || !frame->is_fresh(max_age)) { break; }
+            ret.push_back(std::move(frame));
+        }
+        return ret;
+    }
+
+    frame_ptr capture_service::read(const uint64_t index) const
+    {
+        slot& s = ring_[index % capacity_];
+
+        // announce the read before checking the sequence, the publisher announces
+        // the write before checking the readers, so one of both always backs off.
+        s.readers.fetch_add(1, std::memory_order_seq_cst);
+        frame_ptr ret;
+        if (s.sequence.load(std::memory_order_seq_cst) == index + 1) { ret = s.frame; }
+        s.readers.fetch_sub(1, std::memory_order_release);
+        return ret;
+    }
+
+    void capture_service::run()
+    {
+        while (running_) {
+            const auto next = std::chrono::steady_clock::now() + interval_;
+            try {
+                publish(capture_frame());
+            } catch (const std::exception& e) {
+                get_logger()->warn("Capture service failed to capture: {}", e.what());
+            }
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    void capture_service::publish(frame_ptr frame)
+    {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        slot& s = ring_[head % capacity_];
+
+        s.sequence.store(WRITING, std::memory_order_seq_cst);
+        while (s.readers.load(std::memory_order_seq_cst) != 0) {
+            std::this_thread::yield();
+        }
+        s.frame = std::move(frame);
+        s.sequence.store(head + 1, std::memory_order_release);
+        head_.store(head + 1, std::memory_order_release);
+
+        // take the lock so a waiter cant miss the signal between check and wait.
+        { std::lock_guard lock(signal_mutex_); }
+        signal_.notify_all();
+    }
+
+    capture_service* get_capture_service()
+    {
+        static auto instance = new capture_service();
+        return instance;
+    }
+
+    frame_ptr get_next_frame(const uint64_t sequence)
+    {
+        const capture_service* service = get_capture_service();
+        if (service->is_running()) {
+            if (frame_ptr frame = service->wait_newer(sequence,
+                                                      service->get_interval() * 2)) {
+                return frame;
+            }
+        }
+        return capture_frame();
+    }
+}
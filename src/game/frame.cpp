@@ -0,0 +1,96 @@
+#include "asa/game/frame.h"
+#include "asa/game/window.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace asa
+{
+    namespace
+    {
+        std::atomic<uint64_t> next_sequence{1};
+
+        frame_ptr last_frame = nullptr;
+        std::mutex last_frame_mutex;
+
+        thread_local frame_ptr scoped_frame = nullptr;
+    }
+
+    frame::frame(const uint64_t t_sequence, cv::Mat t_image)
+        : sequence(t_sequence), captured_at(std::chrono::steady_clock::now()),
+          image(std::move(t_image)) {}
+
+    std::chrono::milliseconds frame::age() const
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - captured_at);
+    }
+
+    bool frame::is_fresh(const std::chrono::milliseconds max_age) const
+    {
+        return age() <= max_age;
+    }
+
+    cv::Mat frame::crop(const cv::Rect& region) const
+    {
+        const cv::Rect clamped = region & cv::Rect(0, 0, image.cols, image.rows);
+        return image(clamped);
+    }
+
+    frame_ptr capture_frame()
+    {
+        cv::Mat image;
+        {
+            // make sure we are not served the frame that is pinned on this thread.
+            const frame_scope live(nullptr);
+            image = screenshot();
+        }
+
+        auto captured = std::make_shared<const frame>(next_sequence++, std::move(image));
+
+        std::lock_guard lock(last_frame_mutex);
+        if (!last_frame || last_frame->sequence < captured->sequence) {
+            last_frame = captured;
+        }
+        return captured;
+    }
+
+    frame_ptr get_frame(const std::chrono::milliseconds max_age)
+    {
+        if (max_age > 0ms) {
+            if (frame_ptr last = get_last_frame(); last && last->is_fresh(max_age)) {
+                return last;
+            }
+        }
+        return capture_frame();
+    }
+
+    frame_ptr get_last_frame()
+    {
+        std::lock_guard lock(last_frame_mutex);
+        return last_frame;
+    }
+
+    frame_ptr get_scoped_frame()
+    {
+        return scoped_frame;
+    }
+
+    frame_scope::frame_scope(const std::chrono::milliseconds max_age)
+        : previous_(scoped_frame)
+    {
+        frame_ = previous_ ? previous_ : get_frame(max_age);
+        scoped_frame = frame_;
+    }
+
+    frame_scope::frame_scope(frame_ptr t_frame)
+        : frame_(std::move(t_frame)), previous_(scoped_frame)
+    {
+        scoped_frame = frame_;
+    }
+
+    frame_scope::~frame_scope()
+    {
+        scoped_frame = previous_;
+    }
+}
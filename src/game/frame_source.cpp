@@ -0,0 +1,168 @@
+#include "asa/game/frame_source.h"
+#include "asa/core/exceptions.h"
+#include "asa/core/logging.h"
+
+#include <algorithm>
+#include <format>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+namespace asa
+{
+    namespace
+    {
+        const cv::Size WINDOW_SIZE{1920, 1080};
+
+        std::shared_ptr<frame_source> active_source = nullptr;
+        std::mutex source_mutex;
+
+        bool is_image_file(const std::filesystem::path& path)
+        {
+            static const std::vector<std::string> extensions{".png", ".jpg", ".bmp"};
+            return std::ranges::find(extensions, path.extension().string()) !=
+                   extensions.end();
+        }
+
+        void normalize(cv::Mat& image)
+        {
+            if (image.channels() == 4) { cv::cvtColor(image, image, cv::COLOR_BGRA2BGR); }
+            if (image.size() != WINDOW_SIZE) {
+                cv::resize(image, image, WINDOW_SIZE, 0, 0, cv::INTER_LINEAR);
+            }
+        }
+    }
+
+    cv::Vec3b frame_source::pixel(const cv::Point& point)
+    {
+        // points outside of the window read the closest pixel, like a pinned frame.
+        const cv::Point clamped(std::clamp(point.x, 0, WINDOW_SIZE.width - 1),
+                                std::clamp(point.y, 0, WINDOW_SIZE.height - 1));
+        const cv::Mat image = grab({clamped.x, clamped.y, 1, 1});
+        if (image.empty()) { return {0, 0, 0}; }
+        const auto& bgr = image.at<cv::Vec3b>(0, 0);
+        return {bgr[2], bgr[1], bgr[0]};
+    }
+
+    replay_frame_source::replay_frame_source(std::filesystem::path t_path,
+                                             const float t_speed, const double t_fps,
+                                             const bool t_loop)
+        : path_(std::move(t_path)), speed_(t_speed), fps_(t_fps), loop_(t_loop)
+    {
+        if (std::filesystem::is_directory(path_)) {
+            for (const auto& entry: std::filesystem::directory_iterator(path_)) {
+                if (is_image_file(entry.path())) { images_.push_back(entry.path()); }
+            }
+            std::ranges::sort(images_);
+            frame_count_ = static_cast<int64_t>(images_.size());
+        } else if (video_.open(path_.string())) {
+            frame_count_ = static_cast<int64_t>(video_.get(cv::CAP_PROP_FRAME_COUNT));
+            if (const double fps = video_.get(cv::CAP_PROP_FPS); fps > 0) { fps_ = fps; }
+        }
+
+        if (frame_count_ <= 0) {
+            throw asapp_error(std::format("Could not open recording '{}'!",
+                                          path_.string()));
+        }
+        get_logger()->info("Replaying {} frames from '{}' at {}x speed.", frame_count_,
+                           path_.string(), speed_);
+        started_ = std::chrono::steady_clock::now();
+    }
+
+    cv::Mat replay_frame_source::grab(const cv::Rect& region)
+    {
+        std::lock_guard lock(mutex_);
+        const cv::Mat& image = get_image(compute_position());
+        return image(region & cv::Rect({0, 0}, image.size())).clone();
+    }
+
+    bool replay_frame_source::is_available() const
+    {
+        std::lock_guard lock(mutex_);
+        return !is_finished();
+    }
+
+    bool replay_frame_source::step()
+    {
+        std::lock_guard lock(mutex_);
+        stepped_++;
+        return !is_finished();
+    }
+
+    void replay_frame_source::rewind()
+    {
+        std::lock_guard lock(mutex_);
+        stepped_ = 0;
+        started_ = std::chrono::steady_clock::now();
+    }
+
+    int64_t replay_frame_source::get_position() const
+    {
+        std::lock_guard lock(mutex_);
+        return compute_position();
+    }
+
+    int64_t replay_frame_source::compute_position() const
+    {
+        const int64_t position = compute_elapsed_frames();
+        if (loop_) { return position % frame_count_; }
+        return std::min(position, frame_count_ - 1);
+    }
+
+    int64_t replay_frame_source::compute_elapsed_frames() const
+    {
+        int64_t position = stepped_;
+        if (speed_ > 0.f) {
+            const std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - started_;
+            position += static_cast<int64_t>(elapsed.count() * speed_ * fps_);
+        }
+        return position;
+    }
+
+    bool replay_frame_source::is_finished() const
+    {
+        // the position is clamped to the last frame, so only the frames that passed
+        // tell whether the replay moved beyond its end.
+        return !loop_ && compute_elapsed_frames() >= frame_count_;
+    }
+
+    const cv::Mat& replay_frame_source::get_image(const int64_t position)
+    {
+        if (position == loaded_position_) { return loaded_; }
+
+        if (!images_.empty()) {
+            loaded_ = cv::imread(images_[position].string(), cv::IMREAD_COLOR);
+        } else {
+            // decoding forward is far cheaper than seeking, only seek backwards.
+            if (position <= video_position_) {
+                video_.set(cv::CAP_PROP_POS_FRAMES, static_cast<double>(position));
+                video_position_ = position - 1;
+            }
+            while (video_position_ < position && video_.read(loaded_)) {
+                video_position_++;
+            }
+        }
+
+        if (loaded_.empty()) {
+            throw asapp_error(std::format("Could not decode frame {} of '{}'!", position,
+                                          path_.string()));
+        }
+        normalize(loaded_);
+        loaded_position_ = position;
+        return loaded_;
+    }
+
+    void set_frame_source(std::shared_ptr<frame_source> source)
+    {
+        std::lock_guard lock(source_mutex);
+        active_source = std::move(source);
+    }
+
+    std::shared_ptr<frame_source> get_frame_source()
+    {
+        static const auto gdi = std::make_shared<gdi_frame_source>();
+
+        std::lock_guard lock(source_mutex);
+        return active_source ? active_source : gdi;
+    }
+}
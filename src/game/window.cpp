@@ -3,11 +3,15 @@
 #include "asa/core/state.h"
 #include "asa/core/logging.h"
 #include "asa/game/exceptions.h"
+#include "asa/game/frame_source.h"
+#include "asa/core/thread_pool.h"
+#include "asa/vision/ocr_cache.h"
+#include "asa/vision/ocr_engine_pool.h"
 
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 #include <random>
-#include <tesseract/baseapi.h>
 
 namespace asa
 {
@@ -15,7 +19,6 @@ namespace asa
     {
         using keyboard_mapping_t = std::unordered_map<std::string, int>;
 
-        tesseract::TessBaseAPI* tesseract_engine = nullptr;
         HWND hwnd = nullptr;
 
         auto CRASH_WIN_TITLE = "The UE-ShooterGame Game has crashed and will close";
@@ -30,7 +33,8 @@ namespace asa
         constexpr float MAX_UD_SENS = 3.2f;
         constexpr float MAX_FOV = 1.25f;
 
-        std::mutex ocr_mutex;
+        // the tesseract confidence a result needs to be learned by a glyph set.
+        constexpr int GLYPH_LEARN_CONFIDENCE = 90;
 
         const keyboard_mapping_t base_keymap = {
             {"tab", VK_TAB}, {"f1", VK_F1}, {"f2", VK_F2}, {"f3", VK_F3}, {"f4", VK_F4},
@@ -136,72 +140,148 @@ namespace asa
             bi.biClrImportant = 4;
             return bi;
         }
-    }
 
-    void initialize_tesseract()
-    {
-        tesseract_engine = new tesseract::TessBaseAPI();
-        if (tesseract_engine->Init("tessdata", "eng")) {
-            throw tesseract_not_initialized("tessdata");
-        }
-    }
+        cv::Mat capture(const cv::Rect& region, bool direct_capture)
+        {
+            if (hwnd && !IsWindow(hwnd)) { hwnd = nullptr; }
 
-    cv::Mat screenshot(const cv::Rect& region, bool direct_capture)
-    {
-        if (hwnd && !IsWindow(hwnd)) { hwnd = nullptr; }
+            // we cant do direct capture without a window handle
+            direct_capture &= hwnd != nullptr;
+            int32_t width, height;
+
+            if (direct_capture) {
+                RECT rect;
+                GetWindowRect(hwnd, &rect);
+                width = rect.right - rect.left;
+                height = rect.bottom - rect.top;
+
+                if (width != 1920 || height != 1080) {
+                    return capture(region, false);
+                }
+            } else {
+                width = region.width;
+                height = region.height;
+            }
+
+            HDC dc = direct_capture ? GetWindowDC(hwnd) : GetDC(nullptr);
+            HDC mdc = CreateCompatibleDC(dc);
+            HBITMAP bitmap = CreateCompatibleBitmap(dc, width, height);
+
+            SelectObject(mdc, bitmap);
+            if (direct_capture) {
+                PrintWindow(hwnd, mdc, PW_RENDERFULLCONTENT);
+            } else { BitBlt(mdc, 0, 0, width, height, dc, region.x, region.y, SRCCOPY); }
+
+            BITMAPINFOHEADER bi = get_bitmap_info_header(width, height);
+            if (!direct_capture) { bi.biBitCount = 32; } // Use RGBA for BitBlt
 
-        // we cant do direct capture without a window handle
-        direct_capture &= hwnd != nullptr;
-        int32_t width, height;
+            auto mat = cv::Mat(height, width, direct_capture ? CV_8UC3 : CV_8UC4);
 
-        if (direct_capture) {
-            RECT rect;
-            GetWindowRect(hwnd, &rect);
-            width = rect.right - rect.left;
-            height = rect.bottom - rect.top;
+            GetDIBits(mdc, bitmap, 0, height, mat.data,
+                      reinterpret_cast<BITMAPINFO*>(&bi), DIB_RGB_COLORS);
 
-            if (width != 1920 || height != 1080) {
-                return screenshot(region, false);
+            DeleteObject(bitmap);
+            DeleteDC(mdc);
+            ReleaseDC(hwnd, dc);
+
+            // after using BitBlt we have to drop the alpha channel
+            if (!direct_capture) { cvtColor(mat, mat, cv::COLOR_RGBA2RGB); }
+
+            // either the full screen was requested or we used BitBlt, which already only
+            // captures the area of interest, so no cropping is needed.
+            if ((region.width == 1920 && region.height == 1080) || !direct_capture) {
+                return mat;
             }
-        } else {
-            width = region.width;
-            height = region.height;
+
+            return mat(region);
         }
 
-        HDC dc = direct_capture ? GetWindowDC(hwnd) : GetDC(nullptr);
-        HDC mdc = CreateCompatibleDC(dc);
-        HBITMAP bitmap = CreateCompatibleBitmap(dc, width, height);
+        std::optional<cv::Rect> best_location(const cv::Mat& scores,
+                                              const cv::Size& size,
+                                              const float threshold, float* top)
+        {
+            double max_val;
+            cv::Point max_loc;
+            cv::minMaxLoc(scores, nullptr, &max_val, nullptr, &max_loc);
 
-        SelectObject(mdc, bitmap);
-        if (direct_capture) {
-            PrintWindow(hwnd, mdc, PW_RENDERFULLCONTENT);
-        } else { BitBlt(mdc, 0, 0, width, height, dc, region.x, region.y, SRCCOPY); }
+            if (top) { *top = static_cast<float>(max_val); }
 
-        BITMAPINFOHEADER bi = get_bitmap_info_header(width, height);
-        if (!direct_capture) { bi.biBitCount = 32; } // Use RGBA for BitBlt
+            if (max_val < threshold) { return std::nullopt; }
 
-        auto mat = cv::Mat(height, width, direct_capture ? CV_8UC3 : CV_8UC4);
+            return cv::Rect(max_loc.x, max_loc.y, size.width, size.height);
+        }
 
-        GetDIBits(mdc, bitmap, 0, height, mat.data,
-                  reinterpret_cast<BITMAPINFO*>(&bi), DIB_RGB_COLORS);
+        vision::ocr_result recognize(const ocr_request& request)
+        {
+            if (request.glyphs) {
+                const auto read = request.glyphs->read(request.src);
+                if (read && read->confidence >= request.min_confidence) {
+                    return {read->text, static_cast<int>(read->confidence * 100)};
+                }
+            }
 
-        DeleteObject(bitmap);
-        DeleteDC(mdc);
-        ReleaseDC(hwnd, dc);
+            const char* whitelist = request.whitelist.c_str();
+            const uint64_t key = vision::ocr_cache::make_key(request.src, request.mode,
+                                                             whitelist);
+            if (auto cached = vision::get_ocr_cache().get(key)) { return *cached; }
 
-        // after using BitBlt we have to drop the alpha channel
-        if (!direct_capture) { cvtColor(mat, mat, cv::COLOR_RGBA2RGB); }
+            // a tesseract engine is not threadsafe, every thread needs an engine.
+            const auto engine = vision::get_ocr_engine_pool().acquire();
+            vision::ocr_result result = engine->recognize(request.src, request.mode,
+                                                          whitelist);
 
-        // either the full screen was requested or we used BitBlt, which already only
-        // captures the area of interest, so no cropping is needed.
-        if ((region.width == 1920 && region.height == 1080) || !direct_capture) {
-            return mat;
+            if (request.glyphs && result.confidence >= GLYPH_LEARN_CONFIDENCE) {
+                (void)request.glyphs->learn(request.src, result.text);
+            }
+            vision::get_ocr_cache().put(key, result);
+            return result;
         }
+    }
 
-        return mat(region);
+    void initialize_tesseract()
+    {
+        // the other engines are created once OCR runs on more than one thread.
+        vision::get_ocr_engine_pool().reserve(1);
+    }
+
+    cv::Mat screenshot(const cv::Rect& region, const bool direct_capture)
+    {
+        // a frame is pinned for this decision pass, no need to capture again.
+        if (const frame_ptr pinned = get_scoped_frame()) {
+            return screenshot(*pinned, region);
+        }
+
+        if (!direct_capture) { return capture(region, false); }
+        return get_frame_source()->grab(region);
+    }
+
+    cv::Mat screenshot(const frame& frame, const cv::Rect& region)
+    {
+        // callers own the returned image and may modify it, never hand out the
+        // memory of the shared frame.
+        return frame.crop(region).clone();
     }
 
     cv::Vec3b pixel(const cv::Point& point)
+    {
+        if (const frame_ptr pinned = get_scoped_frame()) {
+            const cv::Mat& image = pinned->image;
+            if (image.empty()) { return {0, 0, 0}; }
+
+            const cv::Point clamped(std::clamp(point.x, 0, image.cols - 1),
+                                    std::clamp(point.y, 0, image.rows - 1));
+            const auto& bgr = image.at<cv::Vec3b>(clamped);
+            return {bgr[2], bgr[1], bgr[0]};
+        }
+        return get_frame_source()->pixel(point);
+    }
+
+    cv::Mat gdi_frame_source::grab(const cv::Rect& region)
+    {
+        return capture(region, true);
+    }
+
+    cv::Vec3b gdi_frame_source::pixel(const cv::Point& point)
     {
         HDC hdc = GetWindowDC(nullptr);
         COLORREF color = GetPixel(hdc, point.x, point.y);
@@ -210,6 +290,11 @@ namespace asa
         return {GetRValue(color), GetGValue(color), GetBValue(color)};
     }
 
+    bool gdi_frame_source::is_available() const
+    {
+        return hwnd && IsWindow(hwnd);
+    }
+
     void set_window_focus()
     {
         SetForegroundWindow(hwnd);
@@ -229,40 +314,11 @@ namespace asa
                                    const cv::Mat& mask, float* top,
                                    const int mode)
     {
-        cv::Mat result;
-        if (grayscale) {
-            cv::Mat _template_gray, source_gray;
-            cv::cvtColor(_template, _template_gray, cv::COLOR_RGB2GRAY);
-            cv::cvtColor(source, source_gray, cv::COLOR_RGB2GRAY);
-
-            if (mask.empty()) {
-                matchTemplate(source, _template, result, mode);
-            } else {
-                cv::matchTemplate(source, _template, result, mode, mask);
-            }
-        } else {
-            if (mask.empty()) {
-                matchTemplate(source, _template, result, mode);
-            } else {
-                cv::matchTemplate(source, _template, result, mode, mask);
-            }
-        }
-
-
-        double min_val, max_val;
-        cv::Point min_loc, max_loc;
-        cv::minMaxLoc(result, &min_val, &max_val, &min_loc, &max_loc);
-
-        if (mode == cv::TM_SQDIFF || mode == cv::TM_SQDIFF_NORMED) {
-            max_val = 1.0 - min_val;
-            max_loc = min_loc;
-        }
-
-        if (top) { *top = static_cast<float>(max_val); }
+        const cv::Mat image = grayscale ? vision::to_gray(source) : source;
+        const cv::Mat templ = grayscale ? vision::to_gray(_template) : _template;
+        const cv::Mat scores = vision::match_scores(image, templ, mask, mode);
 
-        if (max_val < threshold) { return std::nullopt; }
-
-        return cv::Rect(max_loc.x, max_loc.y, _template.cols, _template.rows);
+        return best_location(scores, _template.size(), threshold, top);
     }
 
     std::optional<cv::Rect> locate(const cv::Mat& _template, const cv::Rect& region,
@@ -274,36 +330,102 @@ namespace asa
                       mode);
     }
 
-    std::vector<cv::Rect> locate_all(const cv::Mat& _template, const cv::Mat& source,
-                                     const float threshold, const bool grayscale,
-                                     const cv::Mat& mask)
+    std::optional<cv::Rect> locate(const cv::Mat& _template, const frame& frame,
+                                   const cv::Rect& region, const float threshold,
+                                   const bool grayscale, const cv::Mat& mask, float* top,
+                                   const int mode)
+    {
+        return locate(_template, frame.crop(region), threshold, grayscale, mask, top,
+                      mode);
+    }
+
+    std::optional<cv::Rect> locate(const vision::prepared_template& _template,
+                                   const cv::Mat& source, const float threshold,
+                                   const bool grayscale, float* top, const int mode)
     {
-        cv::Mat match_result;
-        cv::matchTemplate(source, _template, match_result, cv::TM_CCOEFF_NORMED,
-                          mask);
+        const int levels = vision::get_usable_pyramid_levels(_template, source.size());
+        const vision::prepared_source prepared(source, grayscale, levels);
 
-        double min_val, max_val;
-        cv::Point min_loc, max_loc;
-        std::vector<cv::Rect> ret;
+        const auto [rect, score] = vision::best_match(prepared, _template, threshold,
+                                                      mode);
+        if (top) { *top = score; }
 
-        while (true) {
-            cv::minMaxLoc(match_result, &min_val, &max_val, &min_loc, &max_loc);
-            if (max_val < threshold) { break; }
+        if (rect.empty() || score < threshold) { return std::nullopt; }
+        return rect;
+    }
 
-            cv::Rect loc{max_loc.x, max_loc.y, _template.cols, _template.rows};
-            rectangle(match_result, {loc.x - 5, loc.y - 5, 15, 15}, {0}, cv::FILLED);
-            ret.push_back(loc);
-        }
-        return ret;
+    std::optional<cv::Rect> locate(const vision::prepared_template& _template,
+                                   const cv::Rect& region, const float threshold,
+                                   const bool grayscale, float* top, const int mode)
+    {
+        return locate(_template, screenshot(region), threshold, grayscale, top, mode);
+    }
+
+    std::optional<cv::Rect> locate(const vision::prepared_template& _template,
+                                   const frame& frame, const cv::Rect& region,
+                                   const float threshold, const bool grayscale,
+                                   float* top, const int mode)
+    {
+        return locate(_template, frame.crop(region), threshold, grayscale, top, mode);
     }
 
-    std::vector<cv::Rect> locate_all(const cv::Mat& _template, const cv::Rect& region,
-                                     const float threshold, const bool grayscale,
-                                     const cv::Mat& mask)
+    std::vector<vision::scored_match> locate_all(const cv::Mat& _template,
+                                                 const cv::Mat& source,
+                                                 const float threshold,
+                                                 const bool grayscale,
+                                                 const cv::Mat& mask)
+    {
+        const cv::Mat image = grayscale ? vision::to_gray(source) : source;
+        const cv::Mat templ = grayscale ? vision::to_gray(_template) : _template;
+        const cv::Mat scores = vision::match_scores(image, templ, mask,
+                                                    cv::TM_CCOEFF_NORMED);
+
+        return vision::find_peaks(scores, _template.size(), threshold);
+    }
+
+    std::vector<vision::scored_match> locate_all(const cv::Mat& _template,
+                                                 const cv::Rect& region,
+                                                 const float threshold,
+                                                 const bool grayscale,
+                                                 const cv::Mat& mask)
     {
         return locate_all(_template, screenshot(region), threshold, grayscale, mask);
     }
 
+    std::vector<vision::scored_match> locate_all(const cv::Mat& _template,
+                                                 const frame& frame,
+                                                 const cv::Rect& region,
+                                                 const float threshold,
+                                                 const bool grayscale,
+                                                 const cv::Mat& mask)
+    {
+        return locate_all(_template, frame.crop(region), threshold, grayscale, mask);
+    }
+
+    std::vector<vision::scored_match> locate_all(
+        const vision::prepared_template& _template, const cv::Mat& source,
+        const float threshold, const bool grayscale)
+    {
+        const int levels = vision::get_usable_pyramid_levels(_template, source.size());
+        const vision::prepared_source prepared(source, grayscale, levels);
+
+        return vision::all_matches(prepared, _template, threshold);
+    }
+
+    std::vector<vision::scored_match> locate_all(
+        const vision::prepared_template& _template, const cv::Rect& region,
+        const float threshold, const bool grayscale)
+    {
+        return locate_all(_template, screenshot(region), threshold, grayscale);
+    }
+
+    std::vector<vision::scored_match> locate_all(
+        const vision::prepared_template& _template, const frame& frame,
+        const cv::Rect& region, const float threshold, const bool grayscale)
+    {
+        return locate_all(_template, frame.crop(region), threshold, grayscale);
+    }
+
     bool match(const cv::Mat& _template, const cv::Mat& source, const float threshold,
                const bool grayscale, const cv::Mat& mask)
     {
@@ -318,19 +440,61 @@ namespace asa
                std::nullopt;
     }
 
+    bool match(const cv::Mat& _template, const frame& frame, const cv::Rect& region,
+               const float threshold, const bool grayscale, const cv::Mat& mask)
+    {
+        return locate(_template, frame.crop(region), threshold, grayscale, mask) !=
+               std::nullopt;
+    }
+
+    bool match(const vision::prepared_template& _template, const cv::Mat& source,
+               const float threshold, const bool grayscale)
+    {
+        return locate(_template, source, threshold, grayscale) != std::nullopt;
+    }
+
+    bool match(const vision::prepared_template& _template, const cv::Rect& region,
+               const float threshold, const bool grayscale)
+    {
+        return locate(_template, screenshot(region), threshold, grayscale) !=
+               std::nullopt;
+    }
+
+    bool match(const vision::prepared_template& _template, const frame& frame,
+               const cv::Rect& region, const float threshold, const bool grayscale)
+    {
+        return locate(_template, frame.crop(region), threshold, grayscale) !=
+               std::nullopt;
+    }
+
     std::string ocr_threadsafe(const cv::Mat& src, const tesseract::PageSegMode mode,
                                const char* whitelist)
     {
-        // Mutex extremely important, tesseract engine is not threadsafe!!!
-        std::lock_guard lock(ocr_mutex);
+        return recognize({src, mode, whitelist}).text;
+    }
 
-        tesseract_engine->SetImage(src.data, src.size().width, src.size().height,
-                                   src.channels(), src.step1());
+    std::string ocr_threadsafe(const cv::Mat& src, vision::glyph_set& glyphs,
+                               const tesseract::PageSegMode mode, const char* whitelist,
+                               const float min_confidence)
+    {
+        return recognize({src, mode, whitelist, &glyphs, min_confidence}).text;
+    }
 
-        tesseract_engine->SetPageSegMode(mode);
-        tesseract_engine->SetVariable("tessedit_char_whitelist", whitelist);
+    std::future<vision::ocr_result> ocr_async(ocr_request request)
+    {
+        return get_thread_pool().submit(
+            [request = std::move(request)]() -> vision::ocr_result {
+                return recognize(request);
+            });
+    }
 
-        return tesseract_engine->GetUTF8Text();
+    std::vector<vision::ocr_result> ocr_batch(const std::span<const ocr_request> requests)
+    {
+        std::vector<vision::ocr_result> ret(requests.size());
+        get_thread_pool().parallel_for(0, requests.size(), [&](const size_t i) -> void {
+            ret[i] = recognize(requests[i]);
+        });
+        return ret;
     }
 
     HWND get_window_handle(const std::optional<std::chrono::seconds>& timeout)
@@ -0,0 +1,169 @@
+#include "asa/ui/components/icon_offset_cache.h"
+#include "asa/core/logging.h"
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+namespace asa
+{
+    namespace
+    {
+        // how much a new accuracy moves the running average of an entry.
+        constexpr float CONFIDENCE_WEIGHT = 0.2f;
+    }
+
+    icon_offset_cache::icon_offset_cache(const int t_verify_interval,
+                                         const int t_max_misses)
+        : verify_interval_(std::max(t_verify_interval, 1)),
+          max_misses_(std::max(t_max_misses, 1)) {}
+
+    std::optional<icon_offset_cache::entry> icon_offset_cache::find(
+        const std::string& item) const
+    {
+        const shard& s = shard_of(item);
+        std::shared_lock lock(s.mutex);
+
+        const auto it = s.entries.find(item);
+        if (it == s.entries.end()) { return std::nullopt; }
+        return it->second;
+    }
+
+    void icon_offset_cache::learn(const std::string& item, const cv::Rect& window,
+                                  const float accuracy)
+    {
+        shard& s = shard_of(item);
+        std::unique_lock lock(s.mutex);
+        s.entries[item] = {window, accuracy, 0, 0};
+    }
+
+    void icon_offset_cache::hit(const std::string& item, const float accuracy)
+    {
+        shard& s = shard_of(item);
+        std::unique_lock lock(s.mutex);
+
+        const auto it = s.entries.find(item);
+        if (it == s.entries.end()) { return; }
+
+        entry& e = it->second;
+        e.confidence += (accuracy - e.confidence) * CONFIDENCE_WEIGHT;
+        e.misses = 0;
+        e.unmatched = 0;
+    }
+
+    bool icon_offset_cache::unmatched(const std::string& item)
+    {
+        shard& s = shard_of(item);
+        std::unique_lock lock(s.mutex);
+
+        const auto it = s.entries.find(item);
+        if (it == s.entries.end()) { return false; }
+        return ++it->second.unmatched % verify_interval_ == 0;
+    }
+
+    void icon_offset_cache::miss(const std::string& item, const cv::Rect& window,
+                                 const float accuracy)
+    {
+        shard& s = shard_of(item);
+        std::unique_lock lock(s.mutex);
+
+        const auto it = s.entries.find(item);
+        if (it == s.entries.end()) { return; }
+
+        entry& e = it->second;
+        if (++e.misses >= max_misses_) {
+            get_logger()->debug("Dropping icon offset of '{}' after {} misses.", item,
+                                e.misses);
+            s.entries.erase(it);
+            return;
+        }
+        e.window = window;
+        e.confidence = accuracy;
+        e.unmatched = 0;
+    }
+
+    void icon_offset_cache::forget(const std::string& item)
+    {
+        shard& s = shard_of(item);
+        std::unique_lock lock(s.mutex);
+        s.entries.erase(item);
+    }
+
+    void icon_offset_cache::clear()
+    {
+        for (shard& s: shards_) {
+            std::unique_lock lock(s.mutex);
+            s.entries.clear();
+        }
+    }
+
+    size_t icon_offset_cache::size() const
+    {
+        size_t ret = 0;
+        for (const shard& s: shards_) {
+            std::shared_lock lock(s.mutex);
+            ret += s.entries.size();
+        }
+        return ret;
+    }
+
+    bool icon_offset_cache::load(const std::filesystem::path& path)
+    {
+        std::ifstream file(path);
+        if (!file.is_open()) { return false; }
+
+        // one entry per line, the name of the item and its window are tab separated.
+        size_t loaded = 0;
+        std::string line;
+        while (std::getline(file, line)) {
+            const size_t tab = line.find('\t');
+            if (tab == std::string::npos) { continue; }
+
+            std::istringstream values(line.substr(tab + 1));
+            cv::Rect window;
+            float confidence;
+            if (!(values >> window.x >> window.y >> window.width >> window.height >>
+                  confidence)) { continue; }
+
+            learn(line.substr(0, tab), window, confidence);
+            loaded++;
+        }
+
+        get_logger()->info("Loaded {} icon offsets from '{}'.", loaded, path.string());
+        return true;
+    }
+
+    bool icon_offset_cache::save(const std::filesystem::path& path) const
+    {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file.is_open()) { return false; }
+
+        for (const shard& s: shards_) {
+            std::shared_lock lock(s.mutex);
+            for (const auto& [item, e]: s.entries) {
+                file << item << '\t' << e.window.x << ' ' << e.window.y << ' '
+                        << e.window.width << ' ' << e.window.height << ' '
+                        << e.confidence << '\n';
+            }
+        }
+        return static_cast<bool>(file);
+    }
+
+    icon_offset_cache::shard& icon_offset_cache::shard_of(const std::string& item)
+    {
+        return shards_[std::hash<std::string>{}(item) % NUM_SHARDS];
+    }
+
+    const icon_offset_cache::shard& icon_offset_cache::shard_of(
+        const std::string& item) const
+    {
+        return shards_[std::hash<std::string>{}(item) % NUM_SHARDS];
+    }
+
+    icon_offset_cache& get_icon_offset_cache()
+    {
+        static icon_offset_cache cache;
+        return cache;
+    }
+}
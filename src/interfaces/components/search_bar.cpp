@@ -3,6 +3,7 @@
 #include "../../../include/asa/utility.h"
 #include "asa/core/logging.h"
 #include "asa/core/state.h"
+#include "asa/game/capture_service.h"
 
 namespace asa
 {
@@ -22,8 +23,12 @@ namespace asa
         const auto start = std::chrono::system_clock::now();
         int lowest = -1;
         bool has_changed = false;
+        uint64_t seen = 0;
         while (!utility::timedout(start, 800ms)) {
-            const int pixcount = utility::count_matches(area, text_color, 30);
+            // look at every new frame once, served by the capture service if running.
+            const frame_ptr frame = get_next_frame(seen);
+            seen = frame->sequence;
+            const int pixcount = utility::count_matches(*frame, area, text_color, 30);
 
             if (pixcount > 100) { return true; }
 
@@ -1,5 +1,13 @@
 #include "asa/ui/components/slot.h"
+#include "asa/ui/components/icon_offset_cache.h"
 #include "asa/utility.h"
+#include "asa/items/items.h"
+#include "asa/ui/storage/inventory_snapshot.h"
+
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <unordered_map>
 
 namespace asa
 {
@@ -14,8 +22,77 @@ namespace asa
             {item_data::ASCENDANT, cv::Vec3b{2, 167, 172}}
         };
 
-        int CACHED_LOC_PADDING = 5;
-        std::unordered_map<std::string, cv::Rect> cached_locs{};
+        const cv::Vec3b WEIGHT_TEXT_COLOR{128, 231, 255};
+        const cv::Vec3b STACK_COUNT_COLOR{128, 231, 255};
+        const cv::Vec3b FOLDER_NAME_COLOR{182, 237, 248};
+        const cv::Vec3b HOVERED_WHITE{255, 255, 255};
+        const cv::Vec3b DURABILITY_COLOR{1, 156, 136};
+        const cv::Vec3b DURABILITY_LOST_COLOR{6, 25, 38};
+        const cv::Vec3b SPOIL_COLOR{0, 214, 161};
+        const cv::Vec3b SPOILED_COLOR{28, 110, 73};
+
+        constexpr int CACHED_LOC_PADDING = 5;
+
+        // the accuracy an icon has to be found with for its offset to be learned.
+        constexpr float MIN_CACHE_ACCURACY = 0.85f;
+
+        // where the icon of the item sits within the slot.
+        const cv::Rect ICON_AREA{12, 12, 62, 62};
+
+        // how far a pixel may be off the background color to still be background.
+        constexpr int BACKGROUND_TOLERANCE = 15;
+
+        // how many of the most similar items are template matched first, and how
+        // far the shortlist is widened each time none of them is found.
+        constexpr size_t NUM_ITEM_CANDIDATES = 8;
+        constexpr size_t ITEM_CANDIDATES_GROWTH = 4;
+        constexpr size_t MAX_ITEM_CANDIDATES = 128;
+
+        // the lowest confidence of any category, see get_confidence_for_category.
+        constexpr float MIN_CANDIDATE_CONFIDENCE = 0.7f;
+
+        /**
+         * @brief Masks the pixels of a slot image that are not its background, the
+         * background color is taken from a ring just inside the border of the slot.
+         */
+        cv::Mat mask_foreground(const cv::Mat& slot)
+        {
+            std::vector<uchar> samples[3];
+            const auto sample = [&slot, &samples](const int x, const int y) -> void {
+                const uchar* px = slot.ptr<uchar>(y) + x * slot.channels();
+                for (int c = 0; c < 3; c++) { samples[c].push_back(px[c]); }
+            };
+            for (int x = 2; x < slot.cols - 2; x++) {
+                sample(x, 2);
+                sample(x, slot.rows - 3);
+            }
+            for (int y = 3; y < slot.rows - 3; y++) {
+                sample(2, y);
+                sample(slot.cols - 3, y);
+            }
+
+            int background[3];
+            for (int c = 0; c < 3; c++) {
+                auto& values = samples[c];
+                std::ranges::nth_element(values, values.begin() + values.size() / 2);
+                background[c] = values[values.size() / 2];
+            }
+
+            cv::Mat ret(slot.size(), CV_8U);
+            for (int y = 0; y < slot.rows; y++) {
+                const uchar* row = slot.ptr<uchar>(y);
+                uchar* out = ret.ptr<uchar>(y);
+                for (int x = 0; x < slot.cols; x++) {
+                    const uchar* px = row + x * slot.channels();
+                    const bool is_background =
+                        std::abs(px[0] - background[0]) <= BACKGROUND_TOLERANCE &&
+                        std::abs(px[1] - background[1]) <= BACKGROUND_TOLERANCE &&
+                        std::abs(px[2] - background[2]) <= BACKGROUND_TOLERANCE;
+                    out[x] = is_background ? 0 : 255;
+                }
+            }
+            return ret;
+        }
 
         bool has_blueprint_variant(const item_data::ItemType type)
         {
@@ -55,6 +132,22 @@ namespace asa
             return (category == item_data::EQUIPPABLE || category ==
                     item_data::WEAPON);
         }
+
+        // the inventory icons of the items prepared so far, by name of the item.
+        std::unordered_map<std::string, std::unique_ptr<vision::prepared_template> >
+            prepared_icons;
+        std::mutex prepared_icons_mutex;
+
+        const vision::prepared_template& get_prepared_icon(const item& item)
+        {
+            std::scoped_lock lock(prepared_icons_mutex);
+            auto& icon = prepared_icons[item.get_name()];
+            if (!icon) {
+                icon = std::make_unique<vision::prepared_template>(
+                    item.get_inventory_icon(), item.get_inventory_icon_mask());
+            }
+            return *icon;
+        }
     }
 
     cv::Rect item_slot::get_stack_size_area() const
@@ -116,40 +209,26 @@ namespace asa
 
     bool item_slot::is_empty() const
     {
-        static cv::Vec3b weight_text_color{128, 231, 255};
-        const cv::Mat masked = utility::mask(get_weight_area(), weight_text_color, 35);
-        return countNonZero(masked) < 10;
+        return utility::count_matches(get_weight_area(), WEIGHT_TEXT_COLOR, 35) < 10;
     }
 
     bool item_slot::is_folder() const
     {
-        static cv::Vec3b folder_name_color{182, 237, 248};
-        const cv::Mat masked = utility::mask(get_folder_name_area(), folder_name_color,
-                                             30);
-        return cv::countNonZero(masked) > 20;
+        return utility::count_matches(get_folder_name_area(), FOLDER_NAME_COLOR, 30) > 20;
     }
 
     bool item_slot::is_hovered() const
     {
-        static cv::Vec3b hovered_white{255, 255, 255};
         const auto roi = get_hovered_area();
 
-        return cv::countNonZero(utility::mask(roi, hovered_white, 20)) > 200;
+        return utility::count_matches(roi, HOVERED_WHITE, 20) > 200;
     }
 
     bool item_slot::has(const item& item, float* accuracy_out,
                         const bool cache_img) const
     {
-        const bool is_cached = cached_locs.contains(item.get_name());
         if (!cache_img || last_img_.empty()) { last_img_ = screenshot(area); }
-
-        cv::Mat src;
-        if (is_cached) {
-            cv::Rect roi = cached_locs.at(item.get_name());
-            roi.width = std::min(roi.width, last_img_.size().width - roi.x);
-            roi.height = std::min(roi.height, last_img_.size().height - roi.y);
-            src = cv::Mat(last_img_, roi);
-        } else { src = last_img_; }
+        const cv::Rect slot_rect(0, 0, last_img_.cols, last_img_.rows);
 
         cv::Mat templ = item.get_inventory_icon();
         const cv::Mat mask = item.get_inventory_icon_mask();
@@ -157,79 +236,168 @@ namespace asa
         // Match options will differ based on item category.
         const auto category = item.get_data().type;
         const float conf = get_confidence_for_category(category);
-        if (is_grayscale_category(category)) {
-            cv::cvtColor(src, src, cv::COLOR_RGB2GRAY);
-            cv::cvtColor(templ, templ, cv::COLOR_RGB2GRAY);
-        }
+        const bool grayscale = is_grayscale_category(category);
+        if (grayscale) { cv::cvtColor(templ, templ, cv::COLOR_RGB2GRAY); }
+
+        // locates the icon within a region of the slot, in slot coordinates.
+        const auto locate_in = [&](const cv::Rect& roi, float& accuracy) {
+            cv::Mat src(last_img_, roi & slot_rect);
+            if (grayscale) { cv::cvtColor(src, src, cv::COLOR_RGB2GRAY); }
+
+            auto ret = locate(templ, src, conf, false, mask, &accuracy);
+            if (ret) { *ret += (roi & slot_rect).tl(); }
+            return ret;
+        };
+
+        // create a cached location allowing some variance
+        const auto window_of = [](const cv::Rect& match) -> cv::Rect {
+            return {match.x - CACHED_LOC_PADDING, match.y - CACHED_LOC_PADDING,
+                    match.width + (CACHED_LOC_PADDING * 2),
+                    match.height + (CACHED_LOC_PADDING * 2)};
+        };
+
+        icon_offset_cache& cache = get_icon_offset_cache();
+        const std::string& name = item.get_name();
 
         float accuracy = 0.f;
-        const auto match = locate(templ, src, conf, false, mask, &accuracy);
-        if (accuracy_out) { *accuracy_out = accuracy; }
-        if (!match.has_value()) { return false; }
-
-        if (!is_cached && accuracy > 0.85f) {
-            // create a cachec location allowing some variance
-            const cv::Rect cached_loc(match->x - CACHED_LOC_PADDING,
-                                      match->y - CACHED_LOC_PADDING,
-                                      match->width + (CACHED_LOC_PADDING * 2),
-                                      match->height + (CACHED_LOC_PADDING * 2));
-            cached_locs[item.get_name()] = cached_loc;
+        std::optional<cv::Rect> match;
+        if (const auto cached = cache.find(name)) {
+            match = locate_in(cached->window, accuracy);
+            if (match) { cache.hit(name, accuracy); }
+            else if (cache.unmatched(name)) {
+                // not in the window a few times in a row, check whether the icon moved
+                // or is just not in the slot, which says nothing about the window.
+                match = locate_in(slot_rect, accuracy);
+                if (match && accuracy > MIN_CACHE_ACCURACY) {
+                    cache.miss(name, window_of(*match), accuracy);
+                }
+            }
+        } else {
+            match = locate_in(slot_rect, accuracy);
+            if (match && accuracy > MIN_CACHE_ACCURACY) {
+                cache.learn(name, window_of(*match), accuracy);
+            }
         }
-        return true;
+
+        if (accuracy_out) { *accuracy_out = accuracy; }
+        return match.has_value();
     }
 
     std::unique_ptr<item> item_slot::get_item() const
     {
-        if (is_empty()) { return nullptr; }
-        const predetermination_result data = predetermine();
-        bool perf_match_found = false;
-        bool has_matched_once = false;
+        // all the checks below look at the same slot, share one frame between them.
+        const frame_scope scope;
 
-        item* best_match = nullptr;
-        float best_match_accuracy = 0.f;
+        if (is_empty()) { return nullptr; }
 
-        // for (const auto& [type, items]: items::iter_all()) {
-        //     if (perf_match_found) { break; }
-        //     const float category_max_conf = get_max_confidence_for_category(type);
-        //
-        //     for (const auto& item: items) {
-        //         float accuracy = 0.f;
-        //         if (!data.matches((*item)->get_data())) { continue; }
-        //
-        //         if (!has(**item, &accuracy, has_matched_once)) {
-        //             has_matched_once = true;
-        //             continue;
-        //         }
-        //         has_matched_once = true;
-        //
-        //         if (accuracy > best_match_accuracy) {
-        //             best_match = *item;
-        //             best_match_accuracy = accuracy;
-        //             if (accuracy > category_max_conf) {
-        //                 perf_match_found = true;
-        //                 break;
-        //             }
-        //         }
-        //     }
-        // }
+        const item* best_match = identify(predetermine());
         if (!best_match) { return nullptr; }
         return std::make_unique<item>(*best_match,
                                       is_blueprint(best_match->get_data()),
                                       get_quality());
     }
 
-    bool item_slot::get_item_durability(float& durability_out) const
+    std::unique_ptr<item> item_slot::get_item(const inventory_snapshot& snapshot,
+                                              const size_t position) const
+    {
+        if (snapshot.is_empty(position) || snapshot.is_folder(position)) {
+            return nullptr;
+        }
+
+        const frame_scope scope(snapshot.get_frame());
+
+        predetermination_result data;
+        data.has_armor_modifier = snapshot.has_armor_value(position);
+        data.has_damage_modifier = snapshot.has_damage_value(position);
+        data.is_stack = snapshot.is_stack(position);
+        data.has_spoil_bar = snapshot.has_spoil_timer(position);
+        data.has_durability_bar = snapshot.has_durability(position);
+
+        const item* best_match = identify(data);
+        if (!best_match) { return nullptr; }
+        return std::make_unique<item>(*best_match,
+                                      is_blueprint(best_match->get_data()),
+                                      snapshot.get_quality(position));
+    }
+
+    const item* item_slot::identify(const predetermination_result& data) const
+    {
+        // only the few items whose icons look the most alike are template matched,
+        // all of them against the same image of the slot.
+        last_img_ = screenshot(area);
+        const auto query = item_index::describe(cv::Mat(last_img_, ICON_AREA),
+                                                mask_foreground(last_img_)(ICON_AREA));
+        const auto candidates = get_item_index().shortlist(
+            query, MAX_ITEM_CANDIDATES, [&data](const item& candidate) -> bool {
+                return data.matches(candidate.get_data());
+            });
+
+        // the descriptors only rank the items roughly, if none of the closest items
+        // is found the next (more) items are matched before giving up.
+        size_t begin = 0;
+        size_t end = std::min(NUM_ITEM_CANDIDATES, candidates.size());
+        while (begin < end) {
+            if (const item* best_match = identify(
+                std::span(candidates).subspan(begin, end - begin))) {
+                return best_match;
+            }
+            begin = end;
+            end = std::min(end * ITEM_CANDIDATES_GROWTH, candidates.size());
+        }
+        return nullptr;
+    }
+
+    const item* item_slot::identify(
+        const std::span<const item_index::candidate> candidates) const
     {
-        static cv::Vec3b color{1, 156, 136};
+        // the candidates matched in color and grayscale are matched in one batch
+        // each, the source is prepared once per batch.
+        std::vector<const vision::prepared_template*> templates[2];
+        std::vector<std::pair<bool, size_t> > batch_of(candidates.size());
+        for (size_t i = 0; i < candidates.size(); i++) {
+            const item& candidate = *candidates[i].match;
+            const bool grayscale = is_grayscale_category(candidate.get_data().type);
+            batch_of[i] = {grayscale, templates[grayscale].size()};
+            templates[grayscale].push_back(&get_prepared_icon(candidate));
+        }
+
+        std::vector<vision::scored_match> matches[2];
+        for (const bool grayscale: {false, true}) {
+            if (templates[grayscale].empty()) { continue; }
+            matches[grayscale] = vision::match_batch(last_img_, templates[grayscale],
+                                                     MIN_CANDIDATE_CONFIDENCE, grayscale);
+        }
+
+        const item* best_match = nullptr;
+        float best_match_accuracy = 0.f;
+
+        for (size_t i = 0; i < candidates.size(); i++) {
+            const item* candidate = candidates[i].match;
+            const auto category = candidate->get_data().type;
+            const auto& [grayscale, index] = batch_of[i];
+            const auto& [rect, accuracy] = matches[grayscale][index];
+            if (rect.empty() || accuracy < get_confidence_for_category(category)) {
+                continue;
+            }
 
+            if (accuracy > best_match_accuracy) {
+                best_match = candidate;
+                best_match_accuracy = accuracy;
+                if (accuracy > get_max_confidence_for_category(category)) { break; }
+            }
+        }
+        return best_match;
+    }
+
+    bool item_slot::get_item_durability(float& durability_out) const
+    {
         auto roi = get_spoil_or_durability_bar_area();
         roi.y += 2;
         roi.height = 1;
 
         if (is_empty() && !has_durability()) { return false; }
 
-        const auto mask = utility::mask(roi, color, 10);
-        const int green = cv::countNonZero(mask);
+        const int green = utility::count_matches(roi, DURABILITY_COLOR, 10);
 
         durability_out = static_cast<float>(green) / static_cast<float>(roi.width);
         return true;
@@ -237,44 +405,33 @@ namespace asa
 
     bool item_slot::has_armor_value() const
     {
-        return match(embedded::interfaces::armor,
-                             get_armor_or_damage_icon_area(), 0.8f);
+        static const vision::prepared_template armor(embedded::interfaces::armor);
+        return match(armor, get_armor_or_damage_icon_area(), 0.8f);
     }
 
     bool item_slot::has_damage_value() const
     {
-        return match(embedded::interfaces::damage,
-                             get_armor_or_damage_icon_area(), 0.8f);
+        static const vision::prepared_template damage(embedded::interfaces::damage);
+        return match(damage, get_armor_or_damage_icon_area(), 0.8f);
     }
 
     bool item_slot::has_spoil_timer() const
     {
         const auto bar = get_spoil_or_durability_bar_area();
-        static cv::Vec3b spoil_color{0, 214, 161};
-        static cv::Vec3b spoiled_color{28, 110, 73};
-
-        const cv::Mat left = utility::mask(bar, spoil_color, 20);
-        const cv::Mat spoiled = utility::mask(bar, spoiled_color, 20);
-        return cv::countNonZero(left | spoiled) > 100;
+        return utility::count_matches(bar, {SPOIL_COLOR, SPOILED_COLOR}, 20) > 100;
     }
 
     bool item_slot::has_durability() const
     {
         const auto bar = get_spoil_or_durability_bar_area();
-        static cv::Vec3b dura_color{1, 156, 136};
-        static cv::Vec3b dura_lost_color{6, 25, 38};
-
-        const cv::Mat left = utility::mask(bar, dura_color, 20);
-        const cv::Mat lost = utility::mask(bar, dura_lost_color, 20);
-        return cv::countNonZero(left | lost) > 100;
+        const std::vector colors{DURABILITY_COLOR, DURABILITY_LOST_COLOR};
+        return utility::count_matches(bar, colors, 20) > 100;
     }
 
     bool item_slot::is_stack() const
     {
-        static cv::Vec3b stack_count_color{128, 231, 255};
         const auto bar = get_stack_size_area();
-        const auto mask = utility::mask(bar, stack_count_color, 20);
-        return cv::countNonZero(mask) > 30;
+        return utility::count_matches(bar, STACK_COUNT_COLOR, 20) > 30;
     }
 
     bool item_slot::is_blueprint(const item_data& data) const
@@ -286,7 +443,8 @@ namespace asa
         if (data.has_durability) { return !has_durability(); }
 
         // Blueprints always have 0.1 weight
-        return match(embedded::text::bp_weight, get_weight_area(), 0.9f);
+        static const vision::prepared_template bp_weight(embedded::text::bp_weight);
+        return match(bp_weight, get_weight_area(), 0.9f);
     }
 
     item_data::ItemQuality item_slot::get_quality() const
@@ -294,7 +452,7 @@ namespace asa
         const cv::Rect quality_roi(area.x + 2, area.y + 60, 6, 6);
 
         for (const auto& [quality, color]: color_per_quality) {
-            if (cv::countNonZero(utility::mask(quality_roi, color, 25)) > 20) {
+            if (utility::count_matches(quality_roi, color, 25) > 20) {
                 return quality;
             }
         }
@@ -1,8 +1,13 @@
 #include "asa/ui/hud.h"
 #include "asa/utility.h"
 #include "asa/game/game.h"
+#include "asa/game/capture_service.h"
+#include "asa/vision/ocr_pipeline.h"
 
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include "asa/core/state.h"
 
@@ -10,17 +15,66 @@ namespace asa
 {
     namespace
     {
+        // the push notifications area is large enough to be matched at half scale.
+        constexpr vision::pyramid_options NOTIFICATION_PYRAMID{.levels = 1};
+
+        // the glyphs of the item added / removed counts, learned from tesseract reads.
+        vision::glyph_set count_glyphs;
+
+        const auto COUNT_PIPELINE = vision::ocr_pipeline()
+                                    .isolate({255, 255, 255}, 50)
+                                    .crop_to_content()
+                                    .upscale(2)
+                                    .pad(8);
+
+        // the notification icons of the items prepared so far, by name of the item.
+        std::unordered_map<std::string, std::unique_ptr<vision::prepared_template> >
+            notification_icons;
+        std::mutex notification_icons_mutex;
+
+        const vision::prepared_template& get_notification_icon(const item& item)
+        {
+            std::scoped_lock lock(notification_icons_mutex);
+            auto& icon = notification_icons[item.get_name()];
+            if (!icon) {
+                icon = std::make_unique<vision::prepared_template>(
+                    item.get_notification_icon(), item.get_notification_icon_mask(),
+                    NOTIFICATION_PYRAMID);
+            }
+            return *icon;
+        }
+
         bool is_blinking(const cv::Rect& icon, const cv::Vec3b& color,
                          const int min_matches = 500,
                          const std::chrono::milliseconds timeout = 500ms)
         {
-            const auto start = std::chrono::system_clock::now();
-            while (!utility::timedout(start, timeout)) {
-                cv::Mat img = screenshot(icon);
-                if (utility::count_matches(img, color, 30) > min_matches) {
-                    return true;
+            auto blinked = [&icon, &color, min_matches](const frame& frame) -> bool {
+                return utility::count_matches(frame, icon, color, 30) > min_matches;
+            };
+
+            // look back in time first, the icon may already have blinked within the
+            // frames the capture service has buffered, only wait for what is missing.
+            const capture_service* service = get_capture_service();
+            std::chrono::milliseconds covered{0};
+            uint64_t seen = 0;
+            if (service->is_running()) {
+                const std::vector<frame_ptr> recent = service->history(timeout);
+                for (const frame_ptr& frame: recent) {
+                    if (blinked(*frame)) { return true; }
                 }
-                checked_sleep(10ms);
+                if (!recent.empty()) {
+                    covered = recent.back()->age();
+                    seen = recent.front()->sequence;
+                }
+            }
+
+            const auto start = std::chrono::system_clock::now();
+            while (!utility::timedout(start, timeout - covered)) {
+                const frame_ptr frame = get_next_frame(seen);
+                if (blinked(*frame)) { return true; }
+
+                seen = frame->sequence;
+                if (!service->is_running()) { checked_sleep(10ms); }
             }
             return false;
         }
@@ -62,37 +116,47 @@ namespace asa
 
     bool hud::detected_enemy()
     {
-        return detect_push_notification(embedded::text::detected_enemy);
+        static const vision::prepared_template text(embedded::text::detected_enemy, {},
+                                                    NOTIFICATION_PYRAMID);
+        return detect_push_notification(text);
     }
 
     bool hud::is_boss_teleport_in_active()
     {
-        return detect_push_notification(embedded::text::teleport_in);
+        static const vision::prepared_template text(embedded::text::teleport_in, {},
+                                                    NOTIFICATION_PYRAMID);
+        return detect_push_notification(text);
     }
 
     bool hud::is_boss_teleport_out_active()
     {
-        return detect_push_notification(embedded::text::return_time_remaining, 0.85f);
+        static const vision::prepared_template text(embedded::text::return_time_remaining, {},
+                                                    NOTIFICATION_PYRAMID);
+        return detect_push_notification(text, 0.85f);
     }
 
     bool hud::is_boss_on_cooldown()
     {
-        return detect_push_notification(embedded::text::arena_available_in);
+        static const vision::prepared_template text(embedded::text::arena_available_in, {},
+                                                    NOTIFICATION_PYRAMID);
+        return detect_push_notification(text);
     }
 
     bool hud::is_boss_ongoing()
     {
-        return detect_push_notification(embedded::text::arena_time_remaining, 0.85f);
+        static const vision::prepared_template text(embedded::text::arena_time_remaining, {},
+                                                    NOTIFICATION_PYRAMID);
+        return detect_push_notification(text, 0.85f);
     }
 
     bool hud::item_added(item& item, cv::Rect* roi_out) const
     {
         const cv::Rect roi = item_icon_removed_or_added_area;
-        const std::vector<cv::Rect> locations = locate_all(
-            item.get_notification_icon(), roi, 0.75f, false,
-            item.get_notification_icon_mask());
+        const vision::prepared_template& icon = get_notification_icon(item);
+        const auto locations = locate_all(icon, roi, 0.75f);
 
-        auto got_added = [roi, roi_out](const cv::Rect& r) -> bool {
+        auto got_added = [roi, roi_out](const vision::scored_match& found) -> bool {
+            const cv::Rect& r = found.rect;
             const auto loc = cv::Rect(roi.x + r.x + 20, roi.y + r.y - 10, 120, 25);
             if ((loc.x + loc.width) >= 1920 || (loc.y + loc.height > 1080)) {
                 return false;
@@ -107,11 +171,11 @@ namespace asa
     bool hud::item_removed(item& item, cv::Rect* roi_out) const
     {
         const cv::Rect roi = item_icon_removed_or_added_area;
-        const std::vector<cv::Rect> locations = locate_all(
-            item.get_notification_icon(), roi, 0.65f, false,
-            item.get_notification_icon_mask());
+        const vision::prepared_template& icon = get_notification_icon(item);
+        const auto locations = locate_all(icon, roi, 0.65f);
 
-        auto got_removed = [roi, roi_out](const cv::Rect& r) -> bool {
+        auto got_removed = [roi, roi_out](const vision::scored_match& found) -> bool {
+            const cv::Rect& r = found.rect;
             const auto loc = cv::Rect(roi.x + r.x + 20, roi.y + r.y - 10, 120, 30);
             if ((loc.x + loc.width) >= 1920 || (loc.y + loc.height > 1080)) {
                 return false;
@@ -137,11 +201,10 @@ namespace asa
         }
 
         roi = {roi.x, roi.y, x_loc->x, roi.height};
-        const cv::Mat img = screenshot(roi);
-        const cv::Mat mask = utility::mask(img, cv::Vec3b{255, 255, 255}, 50);
+        const cv::Mat mask = COUNT_PIPELINE.run(screenshot(roi));
 
         const std::string result_string = ocr_threadsafe(
-            mask, tesseract::PSM_SINGLE_WORD, "0123456789");
+            mask, count_glyphs, tesseract::PSM_SINGLE_WORD, "0123456789");
 
         if (result_string.empty() || result_string == "\\n") {
             return false;
@@ -164,11 +227,10 @@ namespace asa
         }
 
         roi = {roi.x - 3, roi.y, x_loc->x, roi.height + 3};
-        cv::Mat img = screenshot(roi);
-        cv::Mat mask = utility::mask(img, cv::Vec3b{255, 255, 255}, 50);
+        const cv::Mat mask = COUNT_PIPELINE.run(screenshot(roi));
 
         const std::string result_string = ocr_threadsafe(
-            mask, tesseract::PSM_SINGLE_WORD, "0123456789");
+            mask, count_glyphs, tesseract::PSM_SINGLE_WORD, "0123456789");
         if (result_string.empty() || result_string == "\\n") {
             std::cerr << "[!] OCR failed, no result determined.\n";
             return false;
@@ -198,7 +260,8 @@ namespace asa
         on ? post_down(keybind) : post_up(keybind);
     }
 
-    bool hud::detect_push_notification(const cv::Mat& notification, const float variance)
+    bool hud::detect_push_notification(const vision::prepared_template& notification,
+                                       const float variance)
     {
         if (match(notification, push_notifications_, variance)) {
             return true;
@@ -246,39 +309,33 @@ namespace asa
 
         toggle_extended(true);
         checked_sleep(std::chrono::milliseconds(100));
-        const cv::Mat mask = utility::mask(screenshot(roi), text, 20);
+        const int matches = utility::count_matches(roi, text, 20);
 
         // preserve the previous hud state if inteded
         if (!was_hud_toggled) { toggle_extended(false); }
 
-        return cv::countNonZero(mask) > 20 || mount_has_level_up();
+        return matches > 20 || mount_has_level_up();
     }
 
     bool hud::is_mount_capped()
     {
         static cv::Vec3b black_weight{0, 0, 0};
 
-        cv::Mat img = screenshot(dino_weightcapped);
-        const cv::Mat mask = utility::mask(img, black_weight, 0);
-        return cv::countNonZero(mask) > 950;
+        return utility::count_matches(dino_weightcapped, black_weight, 0) > 950;
     }
 
     bool hud::is_player_capped()
     {
         static cv::Vec3b black_weight{0, 0, 0};
 
-        cv::Mat img = screenshot(player_weightcapped);
-        const cv::Mat mask = utility::mask(img, black_weight, 0);
-        return cv::countNonZero(mask) > 950;
+        return utility::count_matches(player_weightcapped, black_weight, 0) > 950;
     }
 
     bool hud::can_harvest_target() const
     {
         cv::Vec3b color(123, 154, 155);
 
-        cv::Mat img = screenshot(harvest_action_area);
-        const cv::Mat mask = utility::mask(img, color, 10);
-        return cv::countNonZero(mask) > 300;
+        return utility::count_matches(harvest_action_area, color, 10) > 300;
     }
 
     hud* get_hud()
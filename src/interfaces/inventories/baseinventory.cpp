@@ -6,6 +6,7 @@
 #include "asa/utility.h"
 #include "asa/core/logging.h"
 #include "asa/core/state.h"
+#include "asa/core/thread_pool.h"
 
 namespace asa
 {
@@ -76,7 +77,8 @@ namespace asa
 
     bool base_inventory::is_open() const
     {
-        return match(embedded::interfaces::cb_arrowdown, item_filter.area, 0.8f);
+        static const vision::prepared_template arrow(embedded::interfaces::cb_arrowdown);
+        return match(arrow, item_filter.area, 0.8f);
     }
 
     bool base_inventory::has(const item& item, const bool search)
@@ -124,9 +126,13 @@ namespace asa
         }
 
         if (search_for) { search_bar.search_for(item.get_name()); }
-        for (const item_slot& slot: slots) {
-            if (slot.has(item)) { return &slot; }
-            if (slot.is_empty()) { return nullptr; }
+
+        // one capture for the whole page, the slots are matched against it and only
+        // checked for being empty until the first empty slot.
+        const frame_scope scope;
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (slots[i].has(item)) { return &slots[i]; }
+            if (slots[i].is_empty()) { return nullptr; }
         }
         return nullptr;
     }
@@ -207,11 +213,17 @@ namespace asa
 
     base_inventory& base_inventory::popcorn_all(const PopcornFlags flags)
     {
-        while (!slots[0].is_empty() && is_open()) {
+        while (is_open()) {
+            // one capture per pass, slots only become empty while dropping so a slot
+            // that was empty at the start of the pass still is. only the slots that
+            // are looked at are checked, each counting its weight text in the frame.
+            const frame_scope scope;
+            if (slots[0].is_empty()) { break; }
+
             // for performance reason only check if the slot is empty if the
             // last slot in the inventory is & respect the NoSlotChecks flag.
-            const bool check_empty = !(flags & PopcornFlags_NoSlotChecks) && slots[slots.
-                                         size() - 1].is_empty();
+            const bool check_empty = !(flags & PopcornFlags_NoSlotChecks) &&
+                                     slots.back().is_empty();
 
             post_down(get_action_mapping("DropItem"));
             for (int i = 0; i < MAX_ITEMS_PER_PAGE; i++) {
@@ -478,30 +490,25 @@ namespace asa
         // determination process easier as we can assign one thread per slot from the start
         int num_slots_filled = 0;
         int folder_offset = 0;
-        for (const auto& slot: slots) {
-            if (slot.is_folder()) {
+
+        // one capture for the whole page, every thread determines its slots from the
+        // attributes the snapshot decoded.
+        const inventory_snapshot snapshot(slots);
+
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (snapshot.is_folder(i)) {
                 folder_offset++;
                 continue;
             }
-            if (slot.is_empty()) { break; }
+            if (snapshot.is_empty(i)) { break; }
             num_slots_filled++;
         }
 
         std::cout << "\t[-] " << num_slots_filled << " slots to be determined...\n";
         std::vector<std::unique_ptr<item> > ret(num_slots_filled);
-        std::vector<std::thread> threads;
-        threads.reserve(num_threads);
-
-        for (int i = 0; i < num_threads; i++) {
-            threads.emplace_back(
-                [this, i, &ret, num_threads, num_slots_filled, folder_offset]() -> void {
-                    for (int j = i; j < num_slots_filled; j += num_threads) {
-                        ret[j] = slots[j + folder_offset].get_item();
-                    }
-                });
-        }
-
-        for (auto& thread: threads) { thread.join(); }
+        get_thread_pool().parallel_for(0, num_slots_filled, [&](const size_t i) -> void {
+            ret[i] = slots[i + folder_offset].get_item(snapshot, i + folder_offset);
+        }, TaskPriority::NORMAL, std::max(num_threads, 1));
         return ret;
     }
 }
@@ -0,0 +1,39 @@
+#include "asa/ui/storage/inventory_snapshot.h"
+
+#include <algorithm>
+
+namespace asa
+{
+    inventory_snapshot::inventory_snapshot(const std::span<const item_slot> t_slots,
+                                           frame_ptr t_frame, const bool t_with_items)
+        : frame_(t_frame ? std::move(t_frame) : asa::get_frame()),
+          num_slots_(std::min(t_slots.size(), MAX_SLOTS))
+    {
+        // every predicate below counts the colors of its area in the frame in place.
+        const frame_scope scope(frame_);
+
+        for (size_t i = 0; i < num_slots_; i++) {
+            const item_slot& slot = t_slots[i];
+            folder_[i] = slot.is_folder();
+            empty_[i] = slot.is_empty();
+            if (!t_with_items || folder_[i] || empty_[i]) { continue; }
+
+            // only one of these can be true for any item.
+            armor_[i] = slot.has_armor_value();
+            damage_[i] = !armor_[i] && slot.has_damage_value();
+            stack_[i] = !armor_[i] && !damage_[i] && slot.is_stack();
+
+            spoil_[i] = slot.has_spoil_timer();
+            durability_[i] = !spoil_[i] && slot.has_durability();
+            quality_[i] = slot.get_quality();
+        }
+    }
+
+    size_t inventory_snapshot::get_first_empty() const
+    {
+        for (size_t i = 0; i < num_slots_; i++) {
+            if (empty_[i]) { return i; }
+        }
+        return num_slots_;
+    }
+}
@@ -7,23 +7,18 @@ namespace asa
 {
     bool base_travel_map::destination_button::is_ready() const
     {
-        const cv::Mat mask = utility::mask(area, text_color, 30);
-        mask |= utility::mask(area, text_selected_color, 30);
-        return cv::countNonZero(mask) > 100;
+        return utility::count_matches(area, {text_color, text_selected_color}, 30) > 100;
     }
 
     bool base_travel_map::destination_button::is_on_cooldown() const
     {
-        const cv::Mat mask = utility::mask(area, text_cooldown_color, 30);
-        return cv::countNonZero(mask) > 100;
+        return utility::count_matches(area, text_cooldown_color, 30) > 100;
     }
 
     bool base_travel_map::destination_button::is_selected() const
     {
-        const cv::Mat mask = utility::mask(area, selected_color, 30);
-        mask |= utility::mask(area, hovered_selected_color, 30);
-
-        return cv::countNonZero(mask) > 300;
+        return utility::count_matches(area, {selected_color, hovered_selected_color}, 30) >
+               300;
     }
 
     void base_travel_map::destination_button::select()
@@ -48,8 +43,7 @@ namespace asa
     {
         static cv::Vec3b ready_color{158, 88, 18};
 
-        const auto mask = utility::mask(confirm_button.area, ready_color, 20);
-        return cv::countNonZero(mask) > 50;
+        return utility::count_matches(confirm_button.area, ready_color, 20) > 50;
     }
 
     std::vector<base_travel_map::destination_button> base_travel_map::get_destinations() const
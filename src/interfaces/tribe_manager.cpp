@@ -2,7 +2,11 @@
 #include "asa/ui/exceptions.h"
 #include "asa/utility.h"
 #include "asa/core/state.h"
+#include "asa/core/thread_pool.h"
 #include "asa/network/queries.h"
+#include "asa/vision/color_count.h"
+#include "asa/vision/ocr_engine_pool.h"
+#include "asa/vision/ocr_pipeline.h"
 
 #include <algorithm>
 #include <iostream>
@@ -19,7 +23,7 @@ namespace asa
                 R"(ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz123456789()[]{}-!?/\|+=>*'": )";
         auto TIMESTAMP_OCR_WHITELIST = R"("Day:0123456789, )";
 
-        const std::map<std::string, std::string> OCR_FIXES = {
+        const text_replacer OCR_FIXES({
             {"\"\n", "- "}, {"\n", " "}, {"\"", "'"}, {"}", ")"}, {"{", "("},
             {"- Lvb", "- Lvl"}, {"- iLvl", "- Lvl"}, {"- Lvi", "- Lvl"},
             {"- LvI", "- Lvl"}, {" - Lv ", " - Lvl "}, {"- Lyl", "- Lvl"},
@@ -30,7 +34,7 @@ namespace asa
             {"Pin Codedy", "Pin Coded)"}, {"Wallt", "Wall'!"}, {"!!", "!"}, {"((", "("},
             {"))", ")"}, {"''", "'"}, {"Turret!", "Turret'!"},
             {"(Pin Coded) ", "(Pin Coded)'"}
-        };
+        });
 
         // Multiple events share the same color, but this gives us a basic idea,
         // to get the actual event the contents of the parsed message has to be
@@ -57,33 +61,70 @@ namespace asa
             EventType::DOWNLOADED
         };
 
+        // a message is of the first event in the order that has more than this many
+        // pixels of its color within the tolerance.
+        constexpr int EVENT_COLOR_TOLERANCE = 40;
+        constexpr int MIN_EVENT_PIXELS = 250;
+
+        // the ranges of the event colors in the event order, counted in one pass.
+        const std::vector<vision::color_range> EVENT_RANGES = [] {
+            std::vector<vision::color_range> ret;
+            for (const EventType event: EVENT_ORDER) {
+                ret.push_back(vision::color_range::of(EVENT_COLORS.at(event),
+                                                      EVENT_COLOR_TOLERANCE));
+            }
+            return ret;
+        }();
 
-        tribelog_message::timestamp parse_timestamp(const cv::Mat& src)
-        {
-            static cv::Vec3b time_rgb{192, 192, 192};
-
-            const cv::Mat mask = utility::mask(src, time_rgb, 120);
-            const std::string raw = ocr_threadsafe(
-                mask, tesseract::PSM_SINGLE_LINE, TIMESTAMP_OCR_WHITELIST);
+        // the glyphs of the timestamp font, learned from the timestamps tesseract reads.
+        vision::glyph_set timestamp_glyphs;
 
-            return tribelog_message::timestamp::parse(utility::fix(raw, OCR_FIXES));
-        }
+        const auto TIMESTAMP_PIPELINE = vision::ocr_pipeline()
+                                        .isolate({192, 192, 192}, 120)
+                                        .crop_to_content()
+                                        .upscale(2)
+                                        .pad(8);
 
-        std::string parse_content(const cv::Mat& src, const EventType event)
+        vision::ocr_pipeline make_content_pipeline(const EventType event)
         {
             static cv::Vec3b turret_name_color{192, 192, 192};
 
-            const cv::Mat mask = utility::mask(src, EVENT_COLORS.at(event), 130);
+            vision::ocr_pipeline pipeline;
+            pipeline.isolate(EVENT_COLORS.at(event), 130);
 
             // For enemy dinos or players killed, the chance of a turret name
             // exists
             if (event == EventType::ENEMY_DINO_KILLED || event ==
                 EventType::ENEMY_PLAYER_KILLED) {
-                mask |= utility::mask(src, turret_name_color, 120);
+                pipeline.isolate(turret_name_color, 120);
+            }
+            pipeline.crop_to_content().upscale(2).pad(8);
+            return pipeline;
+        }
+
+        const std::map<EventType, vision::ocr_pipeline> CONTENT_PIPELINES = [] {
+            std::map<EventType, vision::ocr_pipeline> ret;
+            for (const EventType event: EVENT_ORDER) {
+                ret.emplace(event, make_content_pipeline(event));
             }
+            return ret;
+        }();
+
+        ocr_request make_timestamp_request(const cv::Mat& src)
+        {
+            return {TIMESTAMP_PIPELINE.run(src), tesseract::PSM_SINGLE_LINE,
+                    TIMESTAMP_OCR_WHITELIST, &timestamp_glyphs};
+        }
+
+        ocr_request make_content_request(const cv::Mat& src, const EventType event)
+        {
+            return {CONTENT_PIPELINES.at(event).run(src), tesseract::PSM_SINGLE_BLOCK,
+                    CONTENT_OCR_WHITELIST};
+        }
 
-            return ocr_threadsafe(mask, tesseract::PSM_SINGLE_BLOCK,
-                                          CONTENT_OCR_WHITELIST);
+        tribelog_message::timestamp parse_timestamp(const std::string& raw)
+        {
+            return tribelog_message::timestamp::parse(utility::fix(raw, OCR_FIXES));
         }
 
         std::unique_ptr<server> last_server_info = nullptr;
@@ -111,6 +152,34 @@ namespace asa
             if (!last_server_info) { return false; }
             return std::abs(last_server_info->day - timestamp.day) < 2;
         }
+
+        /**
+         * @brief Gets how many rows may be parsed at once, every row reads its timestamp
+         * and content at the same time so each takes up to two engines.
+         */
+        size_t get_max_parse_threads()
+        {
+            const size_t max_engines = vision::get_ocr_engine_pool().get_max_engines();
+            return std::max<size_t>(1, max_engines / 2);
+        }
+
+        /**
+         * @brief Clears a flag once it goes out of scope.
+         */
+        struct flag_guard
+        {
+            std::atomic<bool>& flag;
+
+            ~flag_guard() { flag = false; }
+        };
+    }
+
+    tribe_manager::tribe_manager(std::filesystem::path t_log_directory)
+        : log_directory_(std::move(t_log_directory))
+    {
+        if (log_directory_.empty()) {
+            log_directory_ = utility::get_executable_directory() / "tribelogs";
+        }
     }
 
     bool tribe_manager::is_open() const
@@ -150,44 +219,82 @@ namespace asa
         }
     }
 
-    void tribe_manager::update_tribelogs(const log_update_callback_t& on_finish,
+    bool tribe_manager::update_tribelogs(const log_update_callback_t& on_finish,
                                          const std::chrono::seconds receive_for)
     {
         static std::chrono::milliseconds min_recv_time{500};
-        const bool was_open = is_open();
 
-        open();
-        checked_sleep(receive_for.count() ? receive_for : min_recv_time);
-        const cv::Mat logs = get_current_logs_image();
+        // the previous update is still being parsed, it will report the same events.
+        if (updating_.exchange(true)) { return false; }
+
+        cv::Mat logs;
+        bool was_open;
+        try {
+            (void)store();
+            was_open = is_open();
+            open();
+            checked_sleep(receive_for.count() ? receive_for : min_recv_time);
+            logs = get_current_logs_image();
+        } catch (...) {
+            updating_ = false;
+            throw;
+        }
 
-        std::thread([this, on_finish, logs]() -> void {
+        // runs on the pool so that updates queue up behind slow OCR instead of
+        // piling up as threads.
+        get_thread_pool().post([this, on_finish, logs]() -> void {
+            flag_guard done{updating_};
             if (!refresh_server_data()) { return; }
 
-            const bool is_initial_check = tribelog_.empty();
-            bool any_new = false;
+            // rows that were stored during a previous update are known already, only
+            // rows that were never stored need to be read (again).
+            std::vector<cv::Mat> rows;
+            std::vector<uint64_t> hashes;
+            for (const auto& entry: collect_entries(logs)) {
+                cv::Mat row(logs, entry);
+                const uint64_t hash = vision::content_hash(row);
+                if (!known_rows_.contains(hash)) {
+                    rows.push_back(std::move(row));
+                    hashes.push_back(hash);
+                }
+            }
 
-            const std::vector<cv::Rect> entries = collect_entries(logs);
+            std::vector<tribelog_message> parsed(rows.size());
+            get_thread_pool().parallel_for(0, rows.size(), [&](const size_t i) -> void {
+                parsed[i] = parse(rows[i]);
+            }, TaskPriority::LOW, get_max_parse_threads());
+
+            // merged in row order, so from the oldest to the newest message.
+            const bool is_initial_check = store().empty();
+            bool any_new = false;
             log_entries_t new_;
 
-            for (const auto& entry: entries) {
-                const tribelog_message msg = parse(cv::Mat(logs, entry));
+            for (size_t i = 0; i < parsed.size(); i++) {
+                const tribelog_message& msg = parsed[i];
                 if (is_new_message(msg.time, any_new) &&
-                    is_valid_timestamp(msg.time)) {
+                    is_valid_timestamp(msg.time) && add_message(msg)) {
+                    // misread rows are not remembered so that they are read again.
+                    known_rows_.insert(hashes[i]);
                     if (!is_initial_check) { new_.insert(new_.begin(), msg); }
-                    add_message(msg);
                     any_new = true;
                 }
             }
-            on_finish(tribelog_, new_);
-        }).detach();
+            on_finish(get_logs(), new_);
+        }, TaskPriority::LOW);
+
         if (!was_open) { close(); }
+        return true;
     }
 
     std::vector<cv::Rect> tribe_manager::collect_entries(const cv::Mat& src) const
     {
         // we only care about the first 30 pixels on the x-axis
         const cv::Mat roi(src, cv::Rect(0, 0, 40, src.rows));
-        auto matches = locate_all(embedded::interfaces::day_log, roi, 0.81);
+        std::vector<cv::Rect> matches;
+        for (const auto& [rect, score]: locate_all(embedded::interfaces::day_log, roi,
+                                                   0.81)) {
+            matches.push_back(rect);
+        }
 
         // sort the matches by their y-position in descending order
         std::ranges::sort(matches, [](const auto& a, const auto& b) -> bool {
@@ -215,19 +322,37 @@ namespace asa
     bool tribe_manager::is_new_message(const tribelog_message::timestamp time,
                                        const bool allow_equal) const
     {
-        if (tribelog_.empty()) { return true; }
+        const auto latest = store().get_latest_time();
+        if (!latest) { return true; }
 
-        auto& prev = tribelog_.front().time;
+        const auto& prev = *latest;
 
         if (allow_equal) { return prev < time || prev == time; }
         return prev < time;
     }
 
-    void tribe_manager::add_message(const tribelog_message& msg)
+    bool tribe_manager::add_message(const tribelog_message& msg)
+    {
+        if (!store().append(msg)) { return false; }
+
+        std::lock_guard lock(logs_mutex_);
+        logs_.reset();
+        return true;
+    }
+
+    log_entries_t tribe_manager::get_logs() const
     {
-        tribelog_.insert(tribelog_.begin(), msg);
+        std::lock_guard lock(logs_mutex_);
+        if (!logs_) { logs_ = store().latest(50); }
+        return *logs_;
+    }
 
-        while (tribelog_.size() > 50) { tribelog_.pop_back(); }
+    tribelog_store& tribe_manager::store() const
+    {
+        std::call_once(store_opened_, [this] {
+            store_ = std::make_unique<tribelog_store>(log_directory_);
+        });
+        return *store_;
     }
 
     tribelog_message tribe_manager::parse(const cv::Mat& src)
@@ -238,18 +363,27 @@ namespace asa
         // OCR timestamp seperately so we can use different whitelists.
         cv::Mat timestamp_img = crop_timestamp(src);
 
-        msg.time = parse_timestamp(timestamp_img);
+        std::vector requests{make_timestamp_request(timestamp_img)};
         // We no longer care about the timestamp of this message, black it out.
         timestamp_img.setTo(cv::Scalar(0, 0, 0));
 
         // If this fails theres no point even trying as we can't properly mask.
-        if (msg.type = get_message_event(src); msg.type == EventType::UNKNOWN) {
+        msg.type = get_message_event(src);
+        if (msg.type != EventType::UNKNOWN) {
+            requests.push_back(make_content_request(src, msg.type));
+        }
+
+        // the timestamp and the content are read at the same time on different engines.
+        const std::vector<vision::ocr_result> results = ocr_batch(requests);
+        msg.time = parse_timestamp(results[0].text);
+
+        if (msg.type == EventType::UNKNOWN) {
             std::cerr << "[!] Unknown event: " << msg.time.to_string() << std::endl;
             return msg;
         }
 
         // Parse and fix the actual content of the message.
-        msg.raw_text = parse_content(src, msg.type);
+        msg.raw_text = results[1].text;
         msg.content = utility::fix(msg.raw_text, OCR_FIXES);
 
         if (msg.content.empty()) { msg.content = "???"; } else {
@@ -260,9 +394,11 @@ namespace asa
 
     tribelog_message::EventType tribe_manager::get_message_event(const cv::Mat& src) const
     {
-        for (const tribelog_message::EventType type: EVENT_ORDER) {
-            const cv::Mat mask = utility::mask(src, EVENT_COLORS.at(type), 40);
-            if (cv::countNonZero(mask) > 250) { return type; }
+        std::vector<int> counts(EVENT_RANGES.size());
+        vision::count_each_in_ranges(src, EVENT_RANGES, counts);
+
+        for (size_t i = 0; i < EVENT_ORDER.size(); i++) {
+            if (counts[i] > MIN_EVENT_PIXELS) { return EVENT_ORDER[i]; }
         }
         return tribelog_message::EventType::UNKNOWN;
     }
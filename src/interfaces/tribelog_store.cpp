@@ -0,0 +1,555 @@
+#include "asa/ui/tribelog_store.h"
+#include "asa/core/exceptions.h"
+#include "asa/core/logging.h"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <mutex>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace asa
+{
+    namespace
+    {
+        // every segment starts with the magic, the last byte is the format version.
+        constexpr char SEGMENT_MAGIC[8] = {'A', 'S', 'A', 'T', 'L', 'O', 'G', 1};
+
+        // records are prefixed with the size of their payload and its checksum.
+        constexpr size_t RECORD_HEADER_SIZE = 8;
+
+        // a record is never anywhere near this big, anything bigger is corrupt.
+        constexpr uint32_t MAX_PAYLOAD_SIZE = 64 * 1024;
+
+        // held open (and locked) by the store that writes to the directory.
+        constexpr auto LOCK_FILE = "tribelog.lock";
+
+        constexpr uint64_t NO_THUMBNAIL = UINT64_MAX;
+        constexpr double THUMBNAIL_SCALE = 0.5;
+
+        struct record
+        {
+            int64_t time = 0;
+            uint8_t type = 0;
+            uint64_t thumbnail_offset = NO_THUMBNAIL;
+            uint32_t thumbnail_size = 0;
+            std::string content;
+            std::string raw_text;
+        };
+
+        /**
+         * @brief FNV-1a, the hashes are compared across restarts so they must not
+         * depend on the standard library implementation.
+         */
+        uint64_t fnv1a(const std::string_view data)
+        {
+            uint64_t hash = 0xCBF29CE484222325ull;
+            for (const char c: data) {
+                hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001B3ull;
+            }
+            return hash;
+        }
+
+        template<typename T>
+        void put(std::string& out, const T value)
+        {
+            out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void put_string(std::string& out, const std::string& value)
+        {
+            const auto size = static_cast<uint16_t>(std::min<size_t>(value.size(),
+                                                                     UINT16_MAX));
+            put(out, size);
+            out.append(value, 0, size);
+        }
+
+        template<typename T>
+        bool get(std::string_view& in, T& value)
+        {
+            if (in.size() < sizeof(T)) { return false; }
+            std::memcpy(&value, in.data(), sizeof(T));
+            in.remove_prefix(sizeof(T));
+            return true;
+        }
+
+        bool get_string(std::string_view& in, std::string& value)
+        {
+            uint16_t size;
+            if (!get(in, size) || in.size() < size) { return false; }
+            value.assign(in.substr(0, size));
+            in.remove_prefix(size);
+            return true;
+        }
+
+        std::string encode(const record& rec)
+        {
+            std::string ret;
+            put(ret, rec.time);
+            put(ret, rec.type);
+            put(ret, rec.thumbnail_offset);
+            put(ret, rec.thumbnail_size);
+            put_string(ret, rec.content);
+            put_string(ret, rec.raw_text);
+            return ret;
+        }
+
+        bool decode(std::string_view payload, record& rec)
+        {
+            return get(payload, rec.time) && get(payload, rec.type) &&
+                   get(payload, rec.thumbnail_offset) &&
+                   get(payload, rec.thumbnail_size) &&
+                   get_string(payload, rec.content) && get_string(payload, rec.raw_text);
+        }
+
+        /**
+         * @brief Reads the record at the current position of a segment.
+         *
+         * @return True if a complete record with a valid checksum was read.
+         */
+        bool read_record(std::ifstream& in, std::string& payload)
+        {
+            char header[RECORD_HEADER_SIZE];
+            if (!in.read(header, RECORD_HEADER_SIZE)) { return false; }
+
+            uint32_t size, checksum;
+            std::memcpy(&size, header, sizeof(size));
+            std::memcpy(&checksum, header + sizeof(size), sizeof(checksum));
+            if (size > MAX_PAYLOAD_SIZE) { return false; }
+
+            payload.resize(size);
+            if (!in.read(payload.data(), size)) { return false; }
+            return static_cast<uint32_t>(fnv1a(payload)) == checksum;
+        }
+
+        tribelog_message::timestamp to_timestamp(const int64_t time)
+        {
+            return {
+                static_cast<int32_t>(time / 86400),
+                static_cast<int32_t>(time % 86400 / 3600),
+                static_cast<int32_t>(time % 3600 / 60), static_cast<int32_t>(time % 60)
+            };
+        }
+
+        std::vector<uchar> encode_thumbnail(const cv::Mat& image)
+        {
+            cv::Mat thumbnail;
+            cv::resize(image, thumbnail, cv::Size(), THUMBNAIL_SCALE, THUMBNAIL_SCALE,
+                       cv::INTER_AREA);
+
+            std::vector<uchar> ret;
+            cv::imencode(".png", thumbnail, ret);
+            return ret;
+        }
+    }
+
+    tribelog_store::tribelog_store(std::filesystem::path t_directory,
+                                   const bool t_keep_thumbnails,
+                                   const size_t t_segment_size)
+        : directory_(std::move(t_directory)), keep_thumbnails_(t_keep_thumbnails),
+          segment_size_(t_segment_size)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(directory_, ec);
+        if (ec) {
+            throw asapp_error(std::format("Failed to create tribelog directory '{}': {}",
+                                          directory_.string(), ec.message()));
+        }
+        lock_directory();
+
+        try {
+            load();
+        } catch (...) {
+            unlock_directory();
+            throw;
+        }
+    }
+
+    tribelog_store::~tribelog_store()
+    {
+        segment_out_.close();
+        thumbnails_out_.close();
+        unlock_directory();
+    }
+
+    void tribelog_store::load()
+    {
+        std::vector<uint32_t> segments;
+        for (const auto& entry: std::filesystem::directory_iterator(directory_)) {
+            const std::string name = entry.path().filename().string();
+            if (!name.starts_with("tribelog-") || entry.path().extension() != ".log") {
+                continue;
+            }
+            try { segments.push_back(std::stoul(name.substr(9))); } catch (...) {}
+        }
+        std::ranges::sort(segments);
+
+        for (const uint32_t segment: segments) { load_segment(segment); }
+
+        // keep writing to the last segment unless it is full already.
+        uint32_t active = segments.empty() ? 0 : segments.back();
+        if (!segments.empty() && std::filesystem::file_size(segment_path(active)) >=
+            segment_size_) { active++; }
+        open_segment(active);
+
+        get_logger()->info("Loaded {} tribelog messages from {} segment(s).",
+                           entries_.size(), segments.size());
+    }
+
+    bool tribelog_store::append(const tribelog_message& message)
+    {
+        record rec;
+        rec.time = message.time.sum();
+        rec.type = static_cast<uint8_t>(message.type);
+        rec.content = message.content;
+        rec.raw_text = message.raw_text;
+        const uint64_t content_hash = fnv1a(rec.content);
+
+        std::unique_lock lock(mutex_);
+        if (contains_locked(rec.time, content_hash)) { return false; }
+
+        if (segment_end_ >= segment_size_) { open_segment(segment_ + 1); }
+
+        // the thumbnail is written first so a record never refers to a thumbnail
+        // that was lost, a thumbnail without a record is just never read.
+        if (keep_thumbnails_ && !message.raw_image.empty()) {
+            const std::vector<uchar> thumbnail = encode_thumbnail(message.raw_image);
+            thumbnails_out_.write(reinterpret_cast<const char*>(thumbnail.data()),
+                                  static_cast<std::streamsize>(thumbnail.size()));
+            thumbnails_out_.flush();
+            if (thumbnails_out_) {
+                rec.thumbnail_offset = thumbnails_end_;
+                rec.thumbnail_size = static_cast<uint32_t>(thumbnail.size());
+                thumbnails_end_ += thumbnail.size();
+            } else {
+                get_logger()->warn("Failed to write tribelog thumbnail.");
+                thumbnails_out_.clear();
+                thumbnails_end_ = std::filesystem::file_size(thumbnails_path(segment_));
+            }
+        }
+
+        const std::string payload = encode(rec);
+        std::string header;
+        put(header, static_cast<uint32_t>(payload.size()));
+        put(header, static_cast<uint32_t>(fnv1a(payload)));
+
+        segment_out_.write(header.data(), static_cast<std::streamsize>(header.size()));
+        segment_out_.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        segment_out_.flush();
+        if (!segment_out_) {
+            const std::string path = segment_path(segment_).string();
+            try {
+                rollback();
+            } catch (const std::exception& e) {
+                get_logger()->error("Failed to roll back tribelog segment '{}': {}",
+                                    path, e.what());
+            }
+            throw asapp_error(std::format("Failed to write to tribelog segment '{}'.",
+                                          path));
+        }
+
+        add_to_index({rec.time, content_hash, segment_, segment_end_, message.type});
+        segment_end_ += header.size() + payload.size();
+        return true;
+    }
+
+    bool tribelog_store::contains(const tribelog_message& message) const
+    {
+        std::shared_lock lock(mutex_);
+        return contains_locked(message.time.sum(), fnv1a(message.content));
+    }
+
+    std::vector<tribelog_message> tribelog_store::range(
+        const tribelog_message::timestamp& from, const tribelog_message::timestamp& to,
+        const bool with_images) const
+    {
+        std::vector<index_entry> entries;
+        {
+            std::shared_lock lock(mutex_);
+            entries = collect(by_time_, from.sum(), to.sum());
+        }
+        return read(entries, with_images);
+    }
+
+    std::vector<tribelog_message> tribelog_store::range(
+        const tribelog_message::timestamp& from, const tribelog_message::timestamp& to,
+        const EventType type, const bool with_images) const
+    {
+        if (type < 0 || static_cast<size_t>(type) >= by_type_.size()) { return {}; }
+
+        std::vector<index_entry> entries;
+        {
+            std::shared_lock lock(mutex_);
+            entries = collect(by_type_[type], from.sum(), to.sum());
+        }
+        return read(entries, with_images);
+    }
+
+    std::vector<tribelog_message> tribelog_store::latest(const size_t count,
+                                                         const bool with_images) const
+    {
+        std::vector<index_entry> entries;
+        {
+            std::shared_lock lock(mutex_);
+            const size_t n = std::min(count, by_time_.size());
+            entries.reserve(n);
+            for (auto it = by_time_.rbegin(); it != by_time_.rbegin() + n; ++it) {
+                entries.push_back(entries_[*it]);
+            }
+        }
+        return read(entries, with_images);
+    }
+
+    std::optional<tribelog_message::timestamp> tribelog_store::get_latest_time() const
+    {
+        std::shared_lock lock(mutex_);
+        if (by_time_.empty()) { return std::nullopt; }
+        return to_timestamp(entries_[by_time_.back()].time);
+    }
+
+    size_t tribelog_store::size() const
+    {
+        std::shared_lock lock(mutex_);
+        return entries_.size();
+    }
+
+    void tribelog_store::load_segment(const uint32_t segment)
+    {
+        const std::filesystem::path path = segment_path(segment);
+        std::ifstream in(path, std::ios::binary);
+
+        char magic[sizeof(SEGMENT_MAGIC)];
+        if (!in.read(magic, sizeof(magic)) ||
+            std::memcmp(magic, SEGMENT_MAGIC, sizeof(magic)) != 0) {
+            get_logger()->warn("Skipping tribelog segment '{}', unknown format.",
+                               path.string());
+            return;
+        }
+
+        uint64_t offset = sizeof(SEGMENT_MAGIC);
+        std::string payload;
+        record rec;
+        while (read_record(in, payload) && decode(payload, rec)) {
+            const auto type = rec.type < by_type_.size()
+                                  ? static_cast<EventType>(rec.type)
+                                  : EventType::UNKNOWN;
+            add_to_index({rec.time, fnv1a(rec.content), segment, offset, type});
+            offset += RECORD_HEADER_SIZE + payload.size();
+        }
+
+        // a record that was cut off by a crash, drop it so that appending continues
+        // from the last complete record.
+        in.close();
+        if (const uint64_t size = std::filesystem::file_size(path); size > offset) {
+            get_logger()->warn("Truncating {} bytes of incomplete records from '{}'.",
+                               size - offset, path.string());
+            std::filesystem::resize_file(path, offset);
+        }
+    }
+
+    void tribelog_store::open_segment(const uint32_t segment)
+    {
+        segment_out_.close();
+        thumbnails_out_.close();
+        segment_ = segment;
+
+        const std::filesystem::path path = segment_path(segment);
+        const bool is_new = !std::filesystem::exists(path) ||
+                            std::filesystem::file_size(path) == 0;
+
+        segment_out_.open(path, std::ios::binary | std::ios::app);
+        if (!segment_out_.is_open()) {
+            throw asapp_error(std::format("Failed to open tribelog segment '{}'.",
+                                          path.string()));
+        }
+        if (is_new) {
+            segment_out_.write(SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+            segment_out_.flush();
+        }
+        segment_end_ = std::filesystem::file_size(path);
+
+        if (keep_thumbnails_) {
+            const std::filesystem::path thumbnails = thumbnails_path(segment);
+            thumbnails_out_.open(thumbnails, std::ios::binary | std::ios::app);
+            if (!thumbnails_out_.is_open()) {
+                throw asapp_error(std::format("Failed to open tribelog thumbnails '{}'.",
+                                              thumbnails.string()));
+            }
+            thumbnails_end_ = std::filesystem::file_size(thumbnails);
+        }
+    }
+
+    void tribelog_store::rollback()
+    {
+        segment_out_.close();
+
+        std::error_code ec;
+        std::filesystem::resize_file(segment_path(segment_), segment_end_, ec);
+        if (ec) {
+            // the partial record stays behind, loading stops right before it.
+            get_logger()->warn("Failed to truncate tribelog segment '{}': {}",
+                               segment_path(segment_).string(), ec.message());
+            open_segment(segment_ + 1);
+        } else {
+            open_segment(segment_);
+        }
+    }
+
+#ifdef _WIN32
+    void tribelog_store::lock_directory()
+    {
+        // not shared with anyone, opening it again fails until the handle is closed.
+        const std::filesystem::path path = directory_ / LOCK_FILE;
+        const HANDLE handle = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0,
+                                          nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL,
+                                          nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            throw asapp_error(std::format(
+                "Tribelog directory '{}' is in use by another store.",
+                directory_.string()));
+        }
+        lock_handle_ = handle;
+    }
+
+    void tribelog_store::unlock_directory()
+    {
+        if (lock_handle_) { CloseHandle(lock_handle_); }
+        lock_handle_ = nullptr;
+    }
+#else
+    void tribelog_store::lock_directory()
+    {
+        const std::filesystem::path path = directory_ / LOCK_FILE;
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            throw asapp_error(std::format("Failed to open tribelog lock file '{}'.",
+                                          path.string()));
+        }
+        if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+            close(fd);
+            throw asapp_error(std::format(
+                "Tribelog directory '{}' is in use by another store.",
+                directory_.string()));
+        }
+        lock_fd_ = fd;
+    }
+
+    void tribelog_store::unlock_directory()
+    {
+        if (lock_fd_ >= 0) { close(lock_fd_); }
+        lock_fd_ = -1;
+    }
+#endif
+
+    void tribelog_store::add_to_index(const index_entry& entry)
+    {
+        const auto id = static_cast<uint32_t>(entries_.size());
+        entries_.push_back(entry);
+
+        // messages are mostly appended in order, so this is nearly always the end.
+        const auto time_of = [this](const uint32_t other) -> int64_t {
+            return entries_[other].time;
+        };
+        for (auto* index: {&by_time_, &by_type_[entry.type]}) {
+            index->insert(std::ranges::upper_bound(*index, entry.time, std::less{},
+                                                   time_of), id);
+        }
+    }
+
+    bool tribelog_store::contains_locked(const int64_t time,
+                                         const uint64_t content_hash) const
+    {
+        const auto time_of = [this](const uint32_t id) -> int64_t {
+            return entries_[id].time;
+        };
+        const auto it = std::ranges::lower_bound(by_time_, time, std::less{}, time_of);
+
+        for (auto i = it; i != by_time_.end() && entries_[*i].time == time; ++i) {
+            if (entries_[*i].content_hash == content_hash) { return true; }
+        }
+        return false;
+    }
+
+    std::vector<tribelog_store::index_entry> tribelog_store::collect(
+        const std::vector<uint32_t>& index, const int64_t from, const int64_t to) const
+    {
+        const auto time_of = [this](const uint32_t id) -> int64_t {
+            return entries_[id].time;
+        };
+        const auto first = std::ranges::lower_bound(index, from, std::less{}, time_of);
+        const auto last = std::ranges::upper_bound(index, to, std::less{}, time_of);
+
+        std::vector<index_entry> ret;
+        for (auto it = first; it < last; ++it) { ret.push_back(entries_[*it]); }
+        return ret;
+    }
+
+    std::vector<tribelog_message> tribelog_store::read(
+        const std::vector<index_entry>& entries, const bool with_images) const
+    {
+        std::vector<tribelog_message> ret;
+        ret.reserve(entries.size());
+
+        // the entries are ordered by time so they are mostly in the same segment.
+        std::ifstream segment_in;
+        std::ifstream thumbnails_in;
+        uint32_t open_segment = UINT32_MAX;
+
+        std::string payload;
+        for (const index_entry& entry: entries) {
+            if (entry.segment != open_segment) {
+                segment_in = std::ifstream(segment_path(entry.segment), std::ios::binary);
+                if (with_images) {
+                    thumbnails_in = std::ifstream(thumbnails_path(entry.segment),
+                                                  std::ios::binary);
+                }
+                open_segment = entry.segment;
+            }
+
+            record rec;
+            segment_in.clear();
+            segment_in.seekg(static_cast<std::streamoff>(entry.offset));
+            if (!read_record(segment_in, payload) || !decode(payload, rec)) {
+                get_logger()->warn("Failed to read tribelog record at {} of segment {}.",
+                                   entry.offset, entry.segment);
+                continue;
+            }
+
+            tribelog_message& msg = ret.emplace_back();
+            msg.time = to_timestamp(rec.time);
+            msg.type = entry.type;
+            msg.content = std::move(rec.content);
+            msg.raw_text = std::move(rec.raw_text);
+
+            if (with_images && rec.thumbnail_offset != NO_THUMBNAIL) {
+                std::vector<uchar> thumbnail(rec.thumbnail_size);
+                thumbnails_in.clear();
+                thumbnails_in.seekg(static_cast<std::streamoff>(rec.thumbnail_offset));
+                if (thumbnails_in.read(reinterpret_cast<char*>(thumbnail.data()),
+                                       rec.thumbnail_size)) {
+                    msg.raw_image = cv::imdecode(thumbnail, cv::IMREAD_UNCHANGED);
+                }
+            }
+        }
+        return ret;
+    }
+
+    std::filesystem::path tribelog_store::segment_path(const uint32_t segment) const
+    {
+        return directory_ / std::format("tribelog-{:06}.log", segment);
+    }
+
+    std::filesystem::path tribelog_store::thumbnails_path(const uint32_t segment) const
+    {
+        return directory_ / std::format("tribelog-{:06}.thumbs", segment);
+    }
+}
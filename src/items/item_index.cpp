@@ -0,0 +1,92 @@
+#include "asa/items/item_index.h"
+#include "asa/vision/perceptual_hash.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+
+namespace asa
+{
+    namespace
+    {
+        // how much the hash counts towards the distance, the rest is the histogram.
+        constexpr float HASH_WEIGHT = 0.5f;
+
+        int bin_of(const uchar* px)
+        {
+            return (px[0] >> 6) << 4 | (px[1] >> 6) << 2 | px[2] >> 6;
+        }
+    }
+
+    item_index::descriptor item_index::describe(const cv::Mat& src, const cv::Mat& mask)
+    {
+        descriptor ret;
+        if (src.empty()) { return ret; }
+
+        std::array<int, HISTOGRAM_BINS> counts{};
+        int total = 0;
+        const int channels = src.channels();
+        for (int y = 0; y < src.rows; y++) {
+            const uchar* row = src.ptr<uchar>(y);
+            const uchar* visible = mask.empty() ? nullptr : mask.ptr<uchar>(y);
+            for (int x = 0; x < src.cols; x++) {
+                if (visible && !visible[x]) { continue; }
+                counts[bin_of(row + x * channels)]++;
+                total++;
+            }
+        }
+
+        if (total) {
+            for (int i = 0; i < HISTOGRAM_BINS; i++) {
+                ret.histogram[i] = static_cast<uint8_t>(counts[i] * 255 / total);
+            }
+        }
+
+        // the hidden pixels are black in the hash so the background never matters.
+        if (mask.empty()) { ret.hash = vision::dhash(src); }
+        else {
+            cv::Mat visible = cv::Mat::zeros(src.size(), src.type());
+            src.copyTo(visible, mask);
+            ret.hash = vision::dhash(visible);
+        }
+        return ret;
+    }
+
+    float item_index::distance(const descriptor& a, const descriptor& b)
+    {
+        int histogram_distance = 0;
+        for (int i = 0; i < HISTOGRAM_BINS; i++) {
+            histogram_distance += std::abs(a.histogram[i] - b.histogram[i]);
+        }
+
+        // both histograms sum up to at most 255, so they differ by at most 510.
+        const float histogram = static_cast<float>(histogram_distance) / 510.f;
+        const float hash = static_cast<float>(std::popcount(a.hash ^ b.hash)) / 64.f;
+        return (1.f - HASH_WEIGHT) * histogram + HASH_WEIGHT * hash;
+    }
+
+    void item_index::add(const item& item)
+    {
+        descriptors_.push_back(describe(item.get_inventory_icon(),
+                                        item.get_inventory_icon_mask()));
+        items_.push_back(&item);
+    }
+
+    std::vector<item_index::candidate> item_index::shortlist(
+        const descriptor& query, const size_t count, const filter_t& filter) const
+    {
+        std::vector<candidate> ret;
+        for (size_t i = 0; i < descriptors_.size(); i++) {
+            if (filter && !filter(*items_[i])) { continue; }
+            ret.push_back({items_[i], distance(query, descriptors_[i])});
+        }
+
+        const auto by_distance = [](const candidate& a, const candidate& b) -> bool {
+            return a.distance < b.distance;
+        };
+        const size_t n = std::min(count, ret.size());
+        std::partial_sort(ret.begin(), ret.begin() + n, ret.end(), by_distance);
+        ret.resize(n);
+        return ret;
+    }
+}
@@ -29,6 +29,7 @@ namespace asa
     item_data::item_data(const std::string& t_name, const nlohmann::json& t_data,
                          const bool t_is_blueprint, const ItemQuality t_quality)
         : icon_path(get_field<std::string>(t_data, t_name, "icon")),
+          LOAD_FIELD(bool, icon_exported, t_data, t_name),
           type(item_type_map.at(get_field<std::string>(t_data, t_name, "type"))),
           quality(t_quality), LOAD_FIELD(float, weight, t_data, t_name),
           LOAD_FIELD(int, stack_size, t_data, t_name), is_blueprint(t_is_blueprint),
@@ -1,4 +1,7 @@
 #include "asa/items/items.h"
+#include "asa/utility.h"
+#include "asa/core/logging.h"
+#include "asa/game/asset_pack.h"
 
 namespace asa
 {
@@ -6,6 +9,7 @@ namespace asa
     {
         nlohmann::json json_data;
         std::map<std::string, std::unique_ptr<item> > items;
+        item_index icon_index;
     }
 
     const item& get_item(const std::string& name)
@@ -22,12 +26,25 @@ namespace asa
         return items;
     }
 
+    const item_index& get_item_index()
+    {
+        return icon_index;
+    }
+
     void load_items()
     {
-        json_data = nlohmann::json::parse(embedded::embedded_json);
+        const utility::stopwatch sw;
+        const std::string_view data = get_asset_pack().get_data("itemdata.json");
+        json_data = nlohmann::json::parse(data.begin(), data.end());
 
+        // items that are loaded already are skipped, so only the new ones are indexed
+        // and loading again does not duplicate their descriptors.
         for (auto& [key, value]: json_data.items()) {
-            items.emplace(key, std::make_unique<item>(key, item_data(key, value)));
+            if (items.contains(key)) { continue; }
+            const auto it = items.emplace(
+                key, std::make_unique<item>(key, item_data(key, value))).first;
+            icon_index.add(*it->second);
         }
+        get_logger()->info("Loaded {} items in {}.", items.size(), sw.elapsed());
     }
 }
@@ -1,5 +1,6 @@
 #include "asa/structures/cave_loot_crate.h"
 #include "asa/utility.h"
+#include "asa/vision/ocr_pipeline.h"
 #include <iostream>
 
 #include <iostream>
@@ -40,7 +41,13 @@ namespace asa
             return ANY;
         }
 
-        const auto mask = utility::mask(tooltip_area.value(), tooltip_white, 50);
+        static const auto pipeline = vision::ocr_pipeline()
+                                     .isolate(tooltip_white, 50)
+                                     .crop_to_content()
+                                     .upscale(2)
+                                     .pad(8);
+
+        const cv::Mat mask = pipeline.run(screenshot(tooltip_area.value()));
         const std::string res = ocr_threadsafe(
             mask, tesseract::PSM_SINGLE_LINE, "");
 
@@ -50,7 +57,9 @@ namespace asa
 
     std::optional<cv::Rect> cave_loot_crate::get_info_area()
     {
-        const auto loc = locate(embedded::text::lootcrate, cv::Rect(0, 0, 0, 0));
+        static const vision::prepared_template text(embedded::text::lootcrate, {},
+                                                    {.levels = 2});
+        const auto loc = locate(text, cv::Rect(0, 0, 1920, 1080));
 
         if (!loc.has_value()) { return std::nullopt; }
         return cv::Rect(loc->x - 250, loc->y + loc->height + 2, 350, 30);
@@ -59,7 +68,8 @@ namespace asa
     cave_loot_crate::Quality cave_loot_crate::get_quality_from_tooltip(
         const std::string& tooltip)
     {
-        const std::string fixed = utility::fix(tooltip, {{"Tierl", "Tier1"}});
+        static const text_replacer tooltip_fixes({{"Tierl", "Tier1"}});
+        const std::string fixed = utility::fix(tooltip, tooltip_fixes);
 
         if (is_in_tier(fixed, BLUE_CRATES)) { return BLUE; }
         if (is_in_tier(fixed, YELLOW_CRATES)) { return YELLOW; }
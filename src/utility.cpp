@@ -4,9 +4,18 @@
 #include <Windows.h>
 #include "asa/core/state.h"
 #include "asa/game/window.h"
+#include "asa/game/capture_service.h"
+#include "asa/game/frame.h"
+#include "asa/vision/color_count.h"
 
 namespace asa::utility
 {
+    namespace
+    {
+        // fixes that keep creating new mistakes would otherwise never finish.
+        constexpr int MAX_FIX_PASSES = 8;
+    }
+
     std::optional<cv::Rect> find_multi_interactable_line(
         const cv::Mat& src, bool* match_full)
     {
@@ -64,6 +73,12 @@ namespace asa::utility
         return mask(screenshot(roi), color, variance);
     }
 
+    cv::Mat mask(const frame& frame, const cv::Rect& roi, const cv::Vec3b& color,
+                 const int variance)
+    {
+        return mask(frame.crop(roi), color, variance);
+    }
+
     void get_ranges(const cv::Vec3b& src, cv::Vec3b& low, cv::Vec3b& high, const int v)
     {
         auto [b, g, r] = src.val;
@@ -79,15 +94,44 @@ namespace asa::utility
 
     int count_matches(const cv::Mat& img, const cv::Vec3b& color, const int variance)
     {
-        const cv::Mat masked = mask(img, color, variance);
-        return cv::countNonZero(masked);
+        return vision::count_in_range(img, vision::color_range::of(color, variance));
     }
 
     int count_matches(const cv::Rect& img, const cv::Vec3b& color, int variance)
     {
+        // counting only reads the pixels, no need to copy them out of a pinned frame.
+        if (const frame_ptr pinned = get_scoped_frame()) {
+            return count_matches(*pinned, img, color, variance);
+        }
         return count_matches(screenshot(img), color, variance);
     }
 
+    int count_matches(const frame& frame, const cv::Rect& roi, const cv::Vec3b& color,
+                      const int variance)
+    {
+        return count_matches(frame.crop(roi), color, variance);
+    }
+
+    int count_matches(const cv::Mat& img, const std::vector<cv::Vec3b>& colors,
+                      const int variance)
+    {
+        std::vector<vision::color_range> ranges;
+        ranges.reserve(colors.size());
+        for (const cv::Vec3b& color: colors) {
+            ranges.push_back(vision::color_range::of(color, variance));
+        }
+        return vision::count_in_ranges(img, ranges);
+    }
+
+    int count_matches(const cv::Rect& roi, const std::vector<cv::Vec3b>& colors,
+                      const int variance)
+    {
+        if (const frame_ptr pinned = get_scoped_frame()) {
+            return count_matches(pinned->crop(roi), colors, variance);
+        }
+        return count_matches(screenshot(roi), colors, variance);
+    }
+
     bool pixel_matches(const cv::Vec3b& c1, const cv::Vec3b& c2, const int tolerance)
     {
         return abs(c1[0] - c2[0]) <= tolerance &&
@@ -113,16 +157,31 @@ namespace asa::utility
 
     bool await(const std::function<bool()>& condition, std::chrono::milliseconds timeout)
     {
+        const capture_service* service = get_capture_service();
+
+        // a pinned frame would never change, evaluate on the latest frame of the
+        // capture service if it's running or on live captures otherwise.
+        frame_ptr frame = service->is_running() ? service->latest() : nullptr;
+
         auto start_time = std::chrono::steady_clock::now();
-        while (!condition()) {
+        while (true) {
+            {
+                const frame_scope scope(frame);
+                if (condition()) { return true; }
+            }
             auto current_time = std::chrono::steady_clock::now();
             auto elapsed_time = std::chrono::duration_cast<std::chrono::seconds>(
                 current_time - start_time);
 
             if (elapsed_time >= timeout) { return false; }
             checked_sleep(5ms);
+
+            // no point in evaluating the same frame twice, wait for the next one.
+            frame = service->is_running()
+                        ? service->wait_newer(frame ? frame->sequence : 0,
+                                              service->get_interval() * 2)
+                        : nullptr;
         }
-        return true;
     }
 
     std::chrono::system_clock::time_point from_t(const time_t time)
@@ -204,10 +263,36 @@ namespace asa::utility
         return out;
     }
 
+    std::string fix(const std::string& src, const text_replacer& fixes)
+    {
+        std::string out = src;
+        size_t replaced = 0;
+        int passes = 0;
+        do {
+            out = fixes.replace(out, &replaced);
+        } while (replaced && ++passes < MAX_FIX_PASSES);
+        return out;
+    }
+
     void to_lower(std::string& str)
     {
         std::ranges::transform(str, str.begin(), [](const unsigned char c) {
             return std::tolower(c);
         });
     }
+
+    std::filesystem::path get_executable_directory()
+    {
+        std::wstring path(MAX_PATH, L'\0');
+        DWORD size;
+        while ((size = GetModuleFileNameW(nullptr, path.data(),
+                                          static_cast<DWORD>(path.size()))) ==
+               path.size()) {
+            path.resize(path.size() * 2);
+        }
+        if (size == 0) { return {}; }
+
+        path.resize(size);
+        return std::filesystem::path(path).parent_path();
+    }
 }
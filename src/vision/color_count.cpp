@@ -0,0 +1,392 @@
+#include "asa/vision/color_count.h"
+#include "asa/utility.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstring>
+
+// The AVX2 kernels are compiled for the AVX2 target only, not the whole file, and
+// are only ever called once the CPU was found to support AVX2.
+#if defined(ASAPP_USE_AVX2) && (defined(__x86_64__) || defined(_M_X64))
+#define ASAPP_AVX2_KERNELS
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define AVX2_TARGET
+#else
+#define AVX2_TARGET __attribute__((target("avx2,popcnt")))
+#endif
+#endif
+
+namespace asa::vision
+{
+    namespace
+    {
+        // The largest amount of ranges that can be counted in one pass, more than
+        // that have never been needed to decide a single predicate.
+        constexpr size_t MAX_RANGES = 16;
+
+        void mask_row_scalar(const uchar* row, const int from, const int to,
+                             const std::span<const color_range> ranges, uchar* out)
+        {
+            for (int x = from; x < to; x++) {
+                const uchar* px = row + x * 3;
+                out[x] = std::ranges::any_of(ranges, [px](const color_range& range) {
+                    return range.contains(px);
+                }) ? 255 : 0;
+            }
+        }
+
+        void count_row_each_scalar(const uchar* row, const int from, const int to,
+                                   const std::span<const color_range> ranges,
+                                   const std::span<int> counts)
+        {
+            for (int x = from; x < to; x++) {
+                const uchar* px = row + x * 3;
+                for (size_t i = 0; i < ranges.size(); i++) {
+                    counts[i] += ranges[i].contains(px);
+                }
+            }
+        }
+
+        int count_row_scalar(const uchar* row, const int from, const int to,
+                             const std::span<const color_range> ranges)
+        {
+            int count = 0;
+            for (int x = from; x < to; x++) {
+                const uchar* px = row + x * 3;
+                for (const color_range& range: ranges) {
+                    if (range.contains(px)) {
+                        count++;
+                        break;
+                    }
+                }
+            }
+            return count;
+        }
+
+        int count_scalar(const cv::Mat& src, const std::span<const color_range> ranges)
+        {
+            int count = 0;
+            for (int y = 0; y < src.rows; y++) {
+                count += count_row_scalar(src.ptr<uchar>(y), 0, src.cols, ranges);
+            }
+            return count;
+        }
+
+        void count_each_scalar(const cv::Mat& src,
+                               const std::span<const color_range> ranges,
+                               const std::span<int> counts)
+        {
+            for (int y = 0; y < src.rows; y++) {
+                count_row_each_scalar(src.ptr<uchar>(y), 0, src.cols, ranges, counts);
+            }
+        }
+
+        void mask_scalar(const cv::Mat& src, const std::span<const color_range> ranges,
+                         cv::Mat& dst)
+        {
+            for (int y = 0; y < src.rows; y++) {
+                mask_row_scalar(src.ptr<uchar>(y), 0, src.cols, ranges, dst.ptr<uchar>(y));
+            }
+        }
+
+#if defined(ASAPP_AVX2_KERNELS)
+        bool cpu_supports_avx2()
+        {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) { return false; }
+
+            // the OS has to preserve the upper halves of the ymm registers as well.
+            __cpuid(info, 1);
+            if (!(info[2] & 1 << 27) || (_xgetbv(0) & 0x6) != 0x6) { return false; }
+
+            __cpuidex(info, 7, 0);
+            return info[1] & 1 << 5;
+#else
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+
+        const bool avx2_supported = cpu_supports_avx2();
+        std::atomic<bool> avx2_enabled = avx2_supported;
+
+        // Bits 0, 3, 6... 63 of the first 64 mask bits and 2, 5, 8... 29 of the last 32,
+        // the first byte (blue) of each of the 32 pixels in a 96 byte block.
+        constexpr uint64_t PIXEL_BITS_LOW = 0x9249249249249249ull;
+        constexpr uint64_t PIXEL_BITS_HIGH = 0x24924924ull;
+
+        /**
+         * @brief The low and high bounds of a range repeated over 96 bytes, the three
+         * vectors start at a byte offset of 0, 32 and 64 (i.e channel 0, 2 and 1).
+         */
+        struct range_vectors
+        {
+            __m256i low[3];
+            __m256i high[3];
+        };
+
+        using range_vector_set = std::array<range_vectors, MAX_RANGES>;
+
+        AVX2_TARGET
+        void broadcast(const std::span<const color_range> ranges, range_vector_set& out)
+        {
+            for (size_t r = 0; r < ranges.size(); r++) {
+                // repeat the 3 channels by doubling them until all 96 bytes are set.
+                alignas(32) uint8_t low[96];
+                alignas(32) uint8_t high[96];
+                std::memcpy(low, ranges[r].low.val, 3);
+                std::memcpy(high, ranges[r].high.val, 3);
+                for (size_t n = 3; n < 96; n *= 2) {
+                    std::memcpy(low + n, low, n);
+                    std::memcpy(high + n, high, n);
+                }
+
+                for (int i = 0; i < 3; i++) {
+                    out[r].low[i] = _mm256_load_si256(
+                        reinterpret_cast<__m256i*>(low + i * 32));
+                    out[r].high[i] = _mm256_load_si256(
+                        reinterpret_cast<__m256i*>(high + i * 32));
+                }
+            }
+        }
+
+        AVX2_TARGET
+        uint32_t in_range_bits(const __m256i data, const __m256i low, const __m256i high)
+        {
+            // unsigned x >= low <=> max(x, low) == x, x <= high <=> min(x, high) == x
+            const __m256i ge = _mm256_cmpeq_epi8(_mm256_max_epu8(data, low), data);
+            const __m256i le = _mm256_cmpeq_epi8(_mm256_min_epu8(data, high), data);
+            return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(ge, le)));
+        }
+
+        struct pixel_block
+        {
+            __m256i data[3];
+        };
+
+        AVX2_TARGET
+        pixel_block load_block(const uchar* block)
+        {
+            return {
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 64))
+            };
+        }
+
+        /**
+         * @brief Matches a block of 32 pixels against a range, the bits of the pixels
+         * in range are set at the positions of `PIXEL_BITS_LOW / HIGH`.
+         */
+        AVX2_TARGET
+        void match_range(const pixel_block& block, const range_vectors& range,
+                         uint64_t& matched_low, uint64_t& matched_high)
+        {
+            const auto& [data] = block;
+            const uint64_t lo = in_range_bits(data[0], range.low[0], range.high[0]) |
+                                static_cast<uint64_t>(in_range_bits(
+                                    data[1], range.low[1], range.high[1])) << 32;
+            const uint64_t hi = in_range_bits(data[2], range.low[2], range.high[2]);
+
+            // a pixel is in range if all 3 of its channel bits are set.
+            matched_low = lo & (lo >> 1 | hi << 63) & (lo >> 2 | hi << 62);
+            matched_high = hi & (hi >> 1) & (hi >> 2);
+        }
+
+        /**
+         * @brief Matches a block of 32 pixels against the ranges, the bits of the
+         * pixels in any range are set at the positions of `PIXEL_BITS_LOW / HIGH`.
+         */
+        AVX2_TARGET
+        void match_block(const uchar* block, const range_vectors* vectors,
+                         const size_t num_vectors, uint64_t& matched_low,
+                         uint64_t& matched_high)
+        {
+            const pixel_block data = load_block(block);
+
+            matched_low = 0;
+            matched_high = 0;
+            for (size_t i = 0; i < num_vectors; i++) {
+                uint64_t lo;
+                uint64_t hi;
+                match_range(data, vectors[i], lo, hi);
+                matched_low |= lo;
+                matched_high |= hi;
+            }
+        }
+
+        AVX2_TARGET
+        int count_avx2(const cv::Mat& src, const std::span<const color_range> ranges)
+        {
+            range_vector_set vectors;
+            broadcast(ranges, vectors);
+
+            int count = 0;
+            for (int y = 0; y < src.rows; y++) {
+                const uchar* row = src.ptr<uchar>(y);
+                int x = 0;
+                for (; x + 32 <= src.cols; x += 32) {
+                    uint64_t matched_low;
+                    uint64_t matched_high;
+                    match_block(row + x * 3, vectors.data(), ranges.size(), matched_low,
+                                matched_high);
+                    count += std::popcount(matched_low & PIXEL_BITS_LOW) +
+                             std::popcount(matched_high & PIXEL_BITS_HIGH);
+                }
+                count += count_row_scalar(row, x, src.cols, ranges);
+            }
+            return count;
+        }
+
+        AVX2_TARGET
+        void count_each_avx2(const cv::Mat& src, const std::span<const color_range> ranges,
+                             const std::span<int> counts)
+        {
+            range_vector_set vectors;
+            broadcast(ranges, vectors);
+
+            for (int y = 0; y < src.rows; y++) {
+                const uchar* row = src.ptr<uchar>(y);
+                int x = 0;
+                for (; x + 32 <= src.cols; x += 32) {
+                    const pixel_block data = load_block(row + x * 3);
+                    for (size_t i = 0; i < ranges.size(); i++) {
+                        uint64_t lo;
+                        uint64_t hi;
+                        match_range(data, vectors[i], lo, hi);
+                        counts[i] += std::popcount(lo & PIXEL_BITS_LOW) +
+                                     std::popcount(hi & PIXEL_BITS_HIGH);
+                    }
+                }
+                count_row_each_scalar(row, x, src.cols, ranges, counts);
+            }
+        }
+
+        AVX2_TARGET
+        void mask_avx2(const cv::Mat& src, const std::span<const color_range> ranges,
+                       cv::Mat& dst)
+        {
+            range_vector_set vectors;
+            broadcast(ranges, vectors);
+
+            for (int y = 0; y < src.rows; y++) {
+                const uchar* row = src.ptr<uchar>(y);
+                uchar* out = dst.ptr<uchar>(y);
+                int x = 0;
+                for (; x + 32 <= src.cols; x += 32) {
+                    uint64_t matched_low;
+                    uint64_t matched_high;
+                    match_block(row + x * 3, vectors.data(), ranges.size(), matched_low,
+                                matched_high);
+
+                    // pixel i starts at bit 3i, the first 22 pixels are in the low bits.
+                    for (int i = 0; i < 22; i++) {
+                        out[x + i] = (matched_low >> (i * 3) & 1) ? 255 : 0;
+                    }
+                    for (int i = 22; i < 32; i++) {
+                        out[x + i] = (matched_high >> (i * 3 - 64) & 1) ? 255 : 0;
+                    }
+                }
+                mask_row_scalar(row, x, src.cols, ranges, out);
+            }
+        }
+#endif
+
+        bool use_avx2()
+        {
+#if defined(ASAPP_AVX2_KERNELS)
+            return avx2_enabled.load(std::memory_order_relaxed);
+#else
+            return false;
+#endif
+        }
+    }
+
+    color_range color_range::of(const cv::Vec3b& color, const int variance)
+    {
+        color_range range;
+        utility::get_ranges(color, range.low, range.high, variance);
+        return range;
+    }
+
+    bool set_avx2_enabled(const bool enabled)
+    {
+#if defined(ASAPP_AVX2_KERNELS)
+        avx2_enabled = enabled && avx2_supported;
+#endif
+        return use_avx2();
+    }
+
+    int count_in_range(const cv::Mat& src, const color_range& range)
+    {
+        return count_in_ranges(src, std::span(&range, 1));
+    }
+
+    int count_in_ranges(const cv::Mat& src, const std::span<const color_range> ranges)
+    {
+        if (src.empty() || ranges.empty()) { return 0; }
+
+        // anything that isnt a plain BGR image takes the slow path, so does the
+        // (never seen) case of more ranges than we can hold.
+        if (src.type() != CV_8UC3 || ranges.size() > MAX_RANGES) {
+            cv::Mat combined = cv::Mat::zeros(src.size(), CV_8U);
+            for (const color_range& range: ranges) {
+                cv::Mat mask;
+                cv::inRange(src, range.low, range.high, mask);
+                combined |= mask;
+            }
+            return cv::countNonZero(combined);
+        }
+
+#if defined(ASAPP_AVX2_KERNELS)
+        if (use_avx2()) { return count_avx2(src, ranges); }
+#endif
+        return count_scalar(src, ranges);
+    }
+
+    void count_each_in_ranges(const cv::Mat& src,
+                              const std::span<const color_range> ranges,
+                              const std::span<int> counts)
+    {
+        std::fill_n(counts.begin(), ranges.size(), 0);
+        if (src.empty() || ranges.empty()) { return; }
+
+        if (src.type() != CV_8UC3 || ranges.size() > MAX_RANGES) {
+            for (size_t i = 0; i < ranges.size(); i++) {
+                counts[i] = count_in_range(src, ranges[i]);
+            }
+            return;
+        }
+
+#if defined(ASAPP_AVX2_KERNELS)
+        if (use_avx2()) { return count_each_avx2(src, ranges, counts); }
+#endif
+        count_each_scalar(src, ranges, counts);
+    }
+
+    void mask_in_ranges(const cv::Mat& src, const std::span<const color_range> ranges,
+                        cv::Mat& dst)
+    {
+        if (src.type() != CV_8UC3 || ranges.size() > MAX_RANGES) {
+            dst.create(src.size(), CV_8U);
+            dst.setTo(0);
+            for (const color_range& range: ranges) {
+                cv::Mat mask;
+                cv::inRange(src, range.low, range.high, mask);
+                dst |= mask;
+            }
+            return;
+        }
+
+        dst.create(src.size(), CV_8U);
+#if defined(ASAPP_AVX2_KERNELS)
+        if (use_avx2()) { return mask_avx2(src, ranges, dst); }
+#endif
+        mask_scalar(src, ranges, dst);
+    }
+}
@@ -0,0 +1,279 @@
+#include "asa/vision/glyph_ocr.h"
+#include "asa/core/exceptions.h"
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cmath>
+#include <format>
+#include <mutex>
+#include <opencv2/imgproc.hpp>
+
+namespace asa::vision
+{
+    namespace
+    {
+        // components smaller than this are noise left over by the color mask.
+        constexpr int MIN_COMPONENT_AREA = 2;
+
+        // the space gap if the set has not seen any spaces yet, relative to the
+        // height of the line.
+        constexpr float DEFAULT_SPACE_GAP = 0.3f;
+
+        // samples closer than this to an existing sample dont add anything new.
+        constexpr float DUPLICATE_DISTANCE = 0.02f;
+
+        // glyphs of learned lines closer than this are taken to be the same glyph,
+        // which has to be read as the same character a few times to become a sample.
+        constexpr float AGREEMENT_DISTANCE = 0.05f;
+
+        std::string_view trim(std::string_view text)
+        {
+            while (!text.empty() && std::isspace(static_cast<uchar>(text.front()))) {
+                text.remove_prefix(1);
+            }
+            while (!text.empty() && std::isspace(static_cast<uchar>(text.back()))) {
+                text.remove_suffix(1);
+            }
+            return text;
+        }
+    }
+
+    void glyph_set::add_sheet(const cv::Mat& sheet, const std::string_view characters)
+    {
+        const std::vector<glyph> glyphs = segment(sheet);
+
+        std::unique_lock lock(mutex_);
+        if (!add(glyphs, characters, true)) {
+            throw asapp_error(std::format(
+                "Glyph sheet of '{}' does not match its {} glyphs!", characters,
+                glyphs.size()));
+        }
+    }
+
+    bool glyph_set::learn(const cv::Mat& src, const std::string_view text)
+    {
+        const std::vector<glyph> glyphs = segment(src);
+
+        std::unique_lock lock(mutex_);
+        return add(glyphs, text, false);
+    }
+
+    std::optional<glyph_read> glyph_set::read(const cv::Mat& src) const
+    {
+        const std::vector<glyph> glyphs = segment(src);
+        if (glyphs.empty()) { return std::nullopt; }
+
+        std::shared_lock lock(mutex_);
+        if (samples_.empty()) { return std::nullopt; }
+
+        const float space_gap = min_space_gap_ > max_glyph_gap_ &&
+                                std::isfinite(min_space_gap_)
+                                    ? (min_space_gap_ + max_glyph_gap_) / 2.f
+                                    : std::max(DEFAULT_SPACE_GAP, max_glyph_gap_);
+
+        glyph_read ret{"", 1.f};
+        for (size_t i = 0; i < glyphs.size(); i++) {
+            if (i > 0 && glyphs[i].gap > space_gap) { ret.text += ' '; }
+
+            // the distance to the closest sample of every character.
+            std::array<float, 128> closest;
+            closest.fill(std::numeric_limits<float>::infinity());
+            for (const sample& sample: samples_) {
+                float& current = closest[static_cast<uchar>(sample.character)];
+                current = std::min(current, distance(glyphs[i], sample.features));
+            }
+
+            const auto best = std::ranges::min_element(closest);
+            const float best_distance = *best;
+            *best = std::numeric_limits<float>::infinity();
+            const float runner_up = std::ranges::min(closest);
+
+            // a glyph is only as certain as it is far from the next best character,
+            // without a next best character there is nothing to tell it apart from.
+            float confidence = 1.f - best_distance;
+            if (runner_up <= 0.f || !std::isfinite(runner_up)) { confidence = 0.f; }
+            else { confidence = std::min(confidence, 1.f - best_distance / runner_up); }
+
+            ret.text += static_cast<char>(best - closest.begin());
+            ret.confidence = std::min(ret.confidence, std::max(confidence, 0.f));
+        }
+        return ret;
+    }
+
+    bool glyph_set::knows(const std::string_view characters) const
+    {
+        std::shared_lock lock(mutex_);
+        return std::ranges::all_of(characters, [this](const char c) -> bool {
+            return std::isspace(static_cast<uchar>(c)) ||
+                   std::ranges::any_of(samples_, [c](const sample& s) -> bool {
+                       return s.character == c;
+                   });
+        });
+    }
+
+    std::vector<glyph_set::glyph> glyph_set::segment(const cv::Mat& src)
+    {
+        if (src.empty()) { return {}; }
+
+        cv::Mat labels;
+        cv::Mat stats;
+        cv::Mat centroids;
+        const int num_labels = cv::connectedComponentsWithStats(
+            src, labels, stats, centroids, 8, CV_32S);
+
+        struct part
+        {
+            cv::Rect box;
+            std::vector<int> labels;
+        };
+
+        std::vector<part> parts;
+        for (int i = 1; i < num_labels; i++) {
+            if (stats.at<int>(i, cv::CC_STAT_AREA) < MIN_COMPONENT_AREA) { continue; }
+            parts.push_back({
+                cv::Rect(stats.at<int>(i, cv::CC_STAT_LEFT),
+                         stats.at<int>(i, cv::CC_STAT_TOP),
+                         stats.at<int>(i, cv::CC_STAT_WIDTH),
+                         stats.at<int>(i, cv::CC_STAT_HEIGHT)),
+                {i}
+            });
+        }
+        std::ranges::sort(parts, {}, [](const part& p) -> int { return p.box.x; });
+
+        // components that overlap horizontally belong to the same glyph, e.g ':'.
+        std::vector<part> merged;
+        for (part& p: parts) {
+            if (!merged.empty() && p.box.x < merged.back().box.br().x) {
+                merged.back().box |= p.box;
+                merged.back().labels.push_back(p.labels.front());
+            } else {
+                merged.push_back(std::move(p));
+            }
+        }
+        if (merged.empty()) { return {}; }
+
+        int line_top = src.rows;
+        int line_bottom = 0;
+        for (const part& p: merged) {
+            line_top = std::min(line_top, p.box.y);
+            line_bottom = std::max(line_bottom, p.box.br().y);
+        }
+        const auto line_height = static_cast<float>(line_bottom - line_top);
+
+        std::vector<glyph> ret;
+        ret.reserve(merged.size());
+        for (size_t i = 0; i < merged.size(); i++) {
+            const part& p = merged[i];
+            glyph g{p.box, {}, p.box.height / line_height,
+                    (p.box.y - line_top) / line_height, p.box.width / line_height, 0.f};
+            if (i > 0) { g.gap = (p.box.x - merged[i - 1].box.br().x) / line_height; }
+
+            // a bit of the cell is set if at least half of the pixels it covers
+            // belong to the glyph, pixels of neighbouring glyphs dont count.
+            for (int cy = 0; cy < CELL_SIZE; cy++) {
+                const int y0 = p.box.y + cy * p.box.height / CELL_SIZE;
+                const int y1 = std::max(y0 + 1,
+                                        p.box.y + (cy + 1) * p.box.height / CELL_SIZE);
+                for (int cx = 0; cx < CELL_SIZE; cx++) {
+                    const int x0 = p.box.x + cx * p.box.width / CELL_SIZE;
+                    const int x1 = std::max(x0 + 1,
+                                            p.box.x + (cx + 1) * p.box.width / CELL_SIZE);
+                    int set = 0;
+                    for (int y = y0; y < y1; y++) {
+                        const int* row = labels.ptr<int>(y);
+                        for (int x = x0; x < x1; x++) {
+                            set += std::ranges::find(p.labels, row[x]) != p.labels.end();
+                        }
+                    }
+                    if (set * 2 >= (y1 - y0) * (x1 - x0)) {
+                        const int bit = cy * CELL_SIZE + cx;
+                        g.cell[bit / 64] |= uint64_t{1} << (bit % 64);
+                    }
+                }
+            }
+            ret.push_back(g);
+        }
+        return ret;
+    }
+
+    float glyph_set::distance(const glyph& a, const glyph& b)
+    {
+        int differing = 0;
+        for (size_t i = 0; i < a.cell.size(); i++) {
+            differing += std::popcount(a.cell[i] ^ b.cell[i]);
+        }
+
+        const float shape = static_cast<float>(differing) / (CELL_SIZE * CELL_SIZE);
+        const float geometry = 0.5f * (std::abs(a.height - b.height) +
+                                       std::abs(a.top - b.top)) +
+                               0.25f * std::abs(a.width - b.width);
+        return std::min(shape + geometry, 1.f);
+    }
+
+    bool glyph_set::add(const std::vector<glyph>& glyphs, std::string_view text,
+                        const bool trusted)
+    {
+        text = trim(text);
+        const auto is_space = [](const char c) -> bool {
+            return std::isspace(static_cast<uchar>(c));
+        };
+        const auto is_known = [is_space](const char c) -> bool {
+            return std::isprint(static_cast<uchar>(c)) || is_space(c);
+        };
+
+        const auto num_chars = text.size() - std::ranges::count_if(text, is_space);
+        if (glyphs.empty() || num_chars != glyphs.size()) { return false; }
+        if (!std::ranges::all_of(text, is_known)) { return false; }
+
+        size_t i = 0;
+        bool after_space = false;
+        for (const char c: text) {
+            if (is_space(c)) {
+                after_space = true;
+                continue;
+            }
+
+            const glyph& g = glyphs[i++];
+            if (i > 1) {
+                if (after_space) { min_space_gap_ = std::min(min_space_gap_, g.gap); }
+                else { max_glyph_gap_ = std::max(max_glyph_gap_, g.gap); }
+            }
+            after_space = false;
+
+            size_t num_samples = 0;
+            bool duplicate = false;
+            for (const sample& s: samples_) {
+                if (s.character != c) { continue; }
+                num_samples++;
+                duplicate |= distance(s.features, g) < DUPLICATE_DISTANCE;
+            }
+            if (duplicate || num_samples >= MAX_SAMPLES) { continue; }
+            if (trusted || agrees(g, c)) { samples_.push_back({c, g}); }
+        }
+        return true;
+    }
+
+    bool glyph_set::agrees(const glyph& g, const char character)
+    {
+        const auto it = std::ranges::find_if(pending_, [&g](const pending_sample& p) {
+            return distance(p.features, g) < AGREEMENT_DISTANCE;
+        });
+
+        if (it == pending_.end()) {
+            if (pending_.size() >= MAX_PENDING) { pending_.erase(pending_.begin()); }
+            pending_.push_back({{character, g}, 1});
+            return false;
+        }
+
+        // the reads disagree on the glyph, start over with the latest one.
+        if (it->character != character) {
+            *it = {{character, g}, 1};
+            return false;
+        }
+
+        if (++it->reads < MIN_AGREEING_READS) { return false; }
+        pending_.erase(it);
+        return true;
+    }
+}
@@ -0,0 +1,80 @@
+#include "asa/vision/ocr_cache.h"
+#include "asa/vision/perceptual_hash.h"
+
+namespace asa::vision
+{
+    ocr_cache::ocr_cache(const size_t t_capacity)
+        : capacity_(std::max<size_t>(t_capacity, 1)) {}
+
+    uint64_t ocr_cache::make_key(const cv::Mat& src, const tesseract::PageSegMode mode,
+                                 const char* whitelist)
+    {
+        uint64_t hash = mix_hash(content_hash(src), static_cast<uint64_t>(mode));
+        for (const char* c = whitelist; c && *c; c++) {
+            hash = mix_hash(hash, static_cast<uchar>(*c));
+        }
+        return hash;
+    }
+
+    std::optional<ocr_result> ocr_cache::get(const uint64_t key)
+    {
+        std::lock_guard lock(mutex_);
+        const auto it = lookup_.find(key);
+        if (it == lookup_.end()) {
+            misses_++;
+            return std::nullopt;
+        }
+
+        hits_++;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return it->second->second;
+    }
+
+    void ocr_cache::put(const uint64_t key, ocr_result result)
+    {
+        std::lock_guard lock(mutex_);
+        if (const auto it = lookup_.find(key); it != lookup_.end()) {
+            it->second->second = std::move(result);
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return;
+        }
+
+        entries_.emplace_front(key, std::move(result));
+        lookup_[key] = entries_.begin();
+        evict();
+    }
+
+    void ocr_cache::clear()
+    {
+        std::lock_guard lock(mutex_);
+        entries_.clear();
+        lookup_.clear();
+    }
+
+    void ocr_cache::set_capacity(const size_t capacity)
+    {
+        std::lock_guard lock(mutex_);
+        capacity_ = std::max<size_t>(capacity, 1);
+        evict();
+    }
+
+    size_t ocr_cache::get_size() const
+    {
+        std::lock_guard lock(mutex_);
+        return entries_.size();
+    }
+
+    void ocr_cache::evict()
+    {
+        while (entries_.size() > capacity_) {
+            lookup_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+    }
+
+    ocr_cache& get_ocr_cache()
+    {
+        static auto instance = new ocr_cache();
+        return *instance;
+    }
+}
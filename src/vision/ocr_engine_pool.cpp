@@ -0,0 +1,131 @@
+#include "asa/vision/ocr_engine_pool.h"
+#include "asa/core/logging.h"
+#include "asa/game/exceptions.h"
+
+#include <thread>
+#include <tesseract/baseapi.h>
+
+namespace asa::vision
+{
+    ocr_engine::ocr_engine(const std::filesystem::path& tessdata,
+                           const std::string& language)
+        : api_(std::make_unique<tesseract::TessBaseAPI>())
+    {
+        if (api_->Init(tessdata.string().c_str(), language.c_str())) {
+            throw tesseract_not_initialized(tessdata);
+        }
+    }
+
+    ocr_engine::~ocr_engine()
+    {
+        api_->End();
+    }
+
+    ocr_result ocr_engine::recognize(const cv::Mat& src,
+                                     const tesseract::PageSegMode mode,
+                                     const char* whitelist)
+    {
+        api_->SetImage(src.data, src.size().width, src.size().height, src.channels(),
+                       static_cast<int>(src.step1()));
+
+        if (mode_ != mode) {
+            api_->SetPageSegMode(mode);
+            mode_ = mode;
+        }
+        if (const char* chars = whitelist ? whitelist : ""; whitelist_ != chars) {
+            api_->SetVariable("tessedit_char_whitelist", chars);
+            whitelist_ = chars;
+        }
+
+        const std::unique_ptr<char[]> text(api_->GetUTF8Text());
+        return {text ? std::string(text.get()) : std::string(), api_->MeanTextConf()};
+    }
+
+    ocr_engine_pool::lease::lease(ocr_engine_pool* t_pool,
+                                  std::unique_ptr<ocr_engine> t_engine)
+        : pool_(t_pool), engine_(std::move(t_engine)) {}
+
+    ocr_engine_pool::lease::~lease()
+    {
+        if (engine_) { pool_->release(std::move(engine_)); }
+    }
+
+    ocr_engine_pool::ocr_engine_pool(std::filesystem::path t_tessdata,
+                                     std::string t_language, const size_t t_max_engines)
+        : tessdata_(std::move(t_tessdata)), language_(std::move(t_language)),
+          max_engines_(std::max<size_t>(t_max_engines, 1)) {}
+
+    ocr_engine_pool::lease ocr_engine_pool::acquire()
+    {
+        std::unique_lock lock(mutex_);
+        available_.wait(lock, [this]() -> bool {
+            return !idle_.empty() || num_engines_ < max_engines_;
+        });
+
+        if (!idle_.empty()) {
+            std::unique_ptr<ocr_engine> engine = std::move(idle_.back());
+            idle_.pop_back();
+            return {this, std::move(engine)};
+        }
+
+        // reserve the slot and initialize outside of the lock, that takes a while.
+        num_engines_++;
+        lock.unlock();
+        try {
+            auto engine = std::make_unique<ocr_engine>(tessdata_, language_);
+            get_logger()->debug("Created tesseract engine #{}.", get_num_engines());
+            return {this, std::move(engine)};
+        } catch (...) {
+            lock.lock();
+            num_engines_--;
+            lock.unlock();
+            available_.notify_one();
+            throw;
+        }
+    }
+
+    void ocr_engine_pool::reserve(const size_t num_engines)
+    {
+        std::vector<lease> leases;
+        while (get_num_engines() < std::min(num_engines, get_max_engines())) {
+            leases.push_back(acquire());
+        }
+    }
+
+    void ocr_engine_pool::set_max_engines(const size_t max_engines)
+    {
+        {
+            std::lock_guard lock(mutex_);
+            max_engines_ = std::max<size_t>(max_engines, 1);
+        }
+        available_.notify_all();
+    }
+
+    size_t ocr_engine_pool::get_max_engines() const
+    {
+        std::lock_guard lock(mutex_);
+        return max_engines_;
+    }
+
+    size_t ocr_engine_pool::get_num_engines() const
+    {
+        std::lock_guard lock(mutex_);
+        return num_engines_;
+    }
+
+    void ocr_engine_pool::release(std::unique_ptr<ocr_engine> engine)
+    {
+        {
+            std::lock_guard lock(mutex_);
+            idle_.push_back(std::move(engine));
+        }
+        available_.notify_one();
+    }
+
+    ocr_engine_pool& get_ocr_engine_pool()
+    {
+        static auto instance = new ocr_engine_pool(
+            "tessdata", "eng", std::max(1u, std::thread::hardware_concurrency()));
+        return *instance;
+    }
+}
@@ -0,0 +1,94 @@
+#include "asa/vision/ocr_pipeline.h"
+
+#include <opencv2/imgproc.hpp>
+
+namespace asa::vision
+{
+    namespace
+    {
+        // the intermediate results of the pipeline runs on this thread, stages write
+        // to them alternately so that the input of a stage is never its output.
+        thread_local cv::Mat scratch[2];
+    }
+
+    ocr_pipeline& ocr_pipeline::isolate(const cv::Vec3b& color, const int variance)
+    {
+        if (stages_.empty() || !std::holds_alternative<isolate_stage>(stages_.back())) {
+            stages_.emplace_back(isolate_stage{});
+        }
+        std::get<isolate_stage>(stages_.back()).ranges.push_back(
+            color_range::of(color, variance));
+        return *this;
+    }
+
+    ocr_pipeline& ocr_pipeline::binarize(const int threshold)
+    {
+        stages_.emplace_back(binarize_stage{threshold});
+        return *this;
+    }
+
+    ocr_pipeline& ocr_pipeline::upscale(const int factor)
+    {
+        if (factor > 1) { stages_.emplace_back(upscale_stage{factor}); }
+        return *this;
+    }
+
+    ocr_pipeline& ocr_pipeline::crop_to_content()
+    {
+        stages_.emplace_back(crop_stage{});
+        return *this;
+    }
+
+    ocr_pipeline& ocr_pipeline::pad(const int pixels)
+    {
+        if (pixels > 0) { stages_.emplace_back(pad_stage{pixels}); }
+        return *this;
+    }
+
+    void ocr_pipeline::run(const cv::Mat& src, cv::Mat& dst) const
+    {
+        if (stages_.empty()) {
+            src.copyTo(dst);
+            return;
+        }
+
+        const cv::Mat* in = &src;
+        for (size_t i = 0; i < stages_.size(); i++) {
+            cv::Mat& out = i + 1 == stages_.size() ? dst : scratch[i % 2];
+
+            std::visit([in, &out](const auto& stage) -> void {
+                using stage_type = std::decay_t<decltype(stage)>;
+
+                if constexpr (std::is_same_v<stage_type, isolate_stage>) {
+                    mask_in_ranges(*in, stage.ranges, out);
+                } else if constexpr (std::is_same_v<stage_type, binarize_stage>) {
+                    if (in->channels() == 3) {
+                        cv::cvtColor(*in, out, cv::COLOR_BGR2GRAY);
+                        cv::threshold(out, out, stage.threshold, 255, cv::THRESH_BINARY);
+                    } else {
+                        cv::threshold(*in, out, stage.threshold, 255, cv::THRESH_BINARY);
+                    }
+                } else if constexpr (std::is_same_v<stage_type, upscale_stage>) {
+                    cv::resize(*in, out, cv::Size(), stage.factor, stage.factor,
+                               cv::INTER_NEAREST);
+                } else if constexpr (std::is_same_v<stage_type, crop_stage>) {
+                    const cv::Rect content = cv::boundingRect(*in);
+                    if (content.empty()) { in->copyTo(out); }
+                    else { (*in)(content).copyTo(out); }
+                } else if constexpr (std::is_same_v<stage_type, pad_stage>) {
+                    cv::copyMakeBorder(*in, out, stage.pixels, stage.pixels, stage.pixels,
+                                       stage.pixels, cv::BORDER_CONSTANT, cv::Scalar(0));
+                }
+            }, stages_[i]);
+
+            in = &out;
+        }
+    }
+
+    cv::Mat ocr_pipeline::run(const cv::Mat& src) const
+    {
+        cv::Mat ret;
+        run(src, ret);
+        return ret;
+    }
+}
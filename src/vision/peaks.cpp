@@ -0,0 +1,98 @@
+#include "asa/vision/peaks.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <unordered_map>
+
+namespace asa::vision
+{
+    namespace
+    {
+        float intersection_over_union(const cv::Rect& a, const cv::Rect& b)
+        {
+            const int intersection = (a & b).area();
+            if (intersection == 0) { return 0.f; }
+
+            return static_cast<float>(intersection) /
+                   static_cast<float>(a.area() + b.area() - intersection);
+        }
+
+        bool is_local_maximum(const cv::Mat& scores, const int x, const int y)
+        {
+            const float value = scores.at<float>(y, x);
+            for (int ny = std::max(0, y - 1); ny <= std::min(scores.rows - 1, y + 1); ny++) {
+                const auto* row = scores.ptr<float>(ny);
+                for (int nx = std::max(0, x - 1); nx <= std::min(scores.cols - 1, x + 1);
+                     nx++) {
+                    if (row[nx] > value) { return false; }
+                }
+            }
+            return true;
+        }
+    }
+
+    std::vector<scored_match> find_peaks(const cv::Mat& scores, const cv::Size& size,
+                                         const float threshold, const size_t max_matches,
+                                         const float max_overlap)
+    {
+        std::vector<scored_match> ret;
+        for (int y = 0; y < scores.rows; y++) {
+            const auto* row = scores.ptr<float>(y);
+            for (int x = 0; x < scores.cols; x++) {
+                // masked matches may score NaN or inf where the source is flat.
+                if (!std::isfinite(row[x]) || row[x] < threshold) { continue; }
+                if (!is_local_maximum(scores, x, y)) { continue; }
+                ret.push_back({{x, y, size.width, size.height}, row[x]});
+            }
+        }
+
+        suppress_overlapping(ret, max_overlap);
+        if (ret.size() > max_matches) { ret.resize(max_matches); }
+        return ret;
+    }
+
+    void suppress_overlapping(std::vector<scored_match>& matches, const float max_overlap)
+    {
+        std::ranges::stable_sort(matches, std::greater{}, &scored_match::score);
+        if (matches.size() < 2) { return; }
+
+        // bucket the kept matches into a grid of the largest match size, any match that
+        // can overlap another is then at most one cell away from it.
+        int cell_width = 1;
+        int cell_height = 1;
+        for (const auto& match: matches) {
+            cell_width = std::max(cell_width, match.rect.width);
+            cell_height = std::max(cell_height, match.rect.height);
+        }
+
+        auto key = [](const int cx, const int cy) -> int64_t {
+            return static_cast<int64_t>(cx) << 32 | static_cast<uint32_t>(cy);
+        };
+
+        std::unordered_map<int64_t, std::vector<cv::Rect> > kept;
+        std::vector<scored_match> ret;
+        for (const auto& match: matches) {
+            const int cx = match.rect.x / cell_width;
+            const int cy = match.rect.y / cell_height;
+            const auto overlaps = [&match, max_overlap](const cv::Rect& other) -> bool {
+                return intersection_over_union(match.rect, other) > max_overlap;
+            };
+
+            bool suppressed = false;
+            for (int dy = -1; dy <= 1 && !suppressed; dy++) {
+                for (int dx = -1; dx <= 1 && !suppressed; dx++) {
+                    const auto it = kept.find(key(cx + dx, cy + dy));
+                    if (it != kept.end()) {
+                        suppressed = std::ranges::any_of(it->second, overlaps);
+                    }
+                }
+            }
+            if (suppressed) { continue; }
+
+            kept[key(cx, cy)].push_back(match.rect);
+            ret.push_back(match);
+        }
+        matches = std::move(ret);
+    }
+}
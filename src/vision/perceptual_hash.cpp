@@ -0,0 +1,120 @@
+#include "asa/vision/perceptual_hash.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <opencv2/imgproc.hpp>
+
+namespace asa::vision
+{
+    namespace
+    {
+        // how much brighter a pixel has to be than its neighbour to set its bit, so
+        // that capture noise on flat backgrounds doesnt flip bits.
+        constexpr int BRIGHTER_MARGIN = 2;
+
+        /**
+         * @brief Reduces an image to a grayscale image of the given size.
+         */
+        cv::Mat reduce(const cv::Mat& src, const cv::Size& size)
+        {
+            cv::Mat gray;
+            if (src.channels() == 4) { cv::cvtColor(src, gray, cv::COLOR_BGRA2GRAY); }
+            else if (src.channels() == 3) { cv::cvtColor(src, gray, cv::COLOR_BGR2GRAY); }
+            else { gray = src; }
+
+            cv::Mat ret;
+            cv::resize(gray, ret, size, 0, 0, cv::INTER_AREA);
+            return ret;
+        }
+
+        /**
+         * @brief Sets a bit for every pixel of a row that is brighter than its right
+         * neighbour, the first pixel ends up in the most significant bit.
+         */
+        uint64_t row_bits(const uchar* row, const int width)
+        {
+            uint64_t bits = 0;
+            for (int x = 0; x + 1 < width; x++) {
+                bits = bits << 1 | (row[x] > row[x + 1] + BRIGHTER_MARGIN);
+            }
+            return bits;
+        }
+    }
+
+    uint64_t dhash(const cv::Mat& src)
+    {
+        if (src.empty()) { return 0; }
+
+        const cv::Mat reduced = reduce(src, {9, 8});
+        uint64_t ret = 0;
+        for (int y = 0; y < 8; y++) {
+            ret = ret << 8 | row_bits(reduced.ptr<uchar>(y), 9);
+        }
+        return ret;
+    }
+
+    uint64_t mix_hash(uint64_t hash, const uint64_t word)
+    {
+        hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+        return hash ^ (hash >> 29);
+    }
+
+    uint64_t content_hash(const cv::Mat& src)
+    {
+        uint64_t hash = mix_hash(0xCBF29CE484222325ull,
+                                 static_cast<uint64_t>(src.rows) << 32 | src.cols);
+        hash = mix_hash(hash, static_cast<uint64_t>(src.type()));
+
+        const size_t row_bytes = static_cast<size_t>(src.cols) * src.elemSize();
+        for (int y = 0; y < src.rows; y++) {
+            const uchar* row = src.ptr<uchar>(y);
+            size_t i = 0;
+            for (; i + 8 <= row_bytes; i += 8) {
+                uint64_t word;
+                std::memcpy(&word, row + i, 8);
+                hash = mix_hash(hash, word);
+            }
+            uint64_t tail = 0;
+            std::memcpy(&tail, row + i, row_bytes - i);
+            hash = mix_hash(hash, tail);
+        }
+        return hash;
+    }
+
+    int hamming_distance(const uint64_t a, const uint64_t b)
+    {
+        return std::popcount(a ^ b);
+    }
+
+    fingerprint_set::fingerprint_set(const size_t t_capacity)
+        : capacity_(std::max<size_t>(t_capacity, 1)) {}
+
+    bool fingerprint_set::contains(const uint64_t hash) const
+    {
+        std::lock_guard lock(mutex_);
+        return std::ranges::find(hashes_, hash) != hashes_.end();
+    }
+
+    bool fingerprint_set::insert(const uint64_t hash)
+    {
+        std::lock_guard lock(mutex_);
+        if (std::ranges::find(hashes_, hash) != hashes_.end()) { return false; }
+
+        hashes_.push_back(hash);
+        while (hashes_.size() > capacity_) { hashes_.pop_front(); }
+        return true;
+    }
+
+    void fingerprint_set::clear()
+    {
+        std::lock_guard lock(mutex_);
+        hashes_.clear();
+    }
+
+    size_t fingerprint_set::get_size() const
+    {
+        std::lock_guard lock(mutex_);
+        return hashes_.size();
+    }
+}
@@ -0,0 +1,54 @@
+#include "asa/vision/prepared_template.h"
+
+#include <opencv2/imgproc.hpp>
+
+namespace asa::vision
+{
+    prepared_template::prepared_template(const cv::Mat& t_template,
+                                         const cv::Mat& t_mask,
+                                         const pyramid_options& t_pyramid)
+        : pyramid_(t_pyramid)
+    {
+        level full;
+        if (t_template.channels() == 4) {
+            cv::cvtColor(t_template, full.bgr, cv::COLOR_BGRA2BGR);
+        } else {
+            full.bgr = t_template;
+        }
+        cv::cvtColor(full.bgr, full.gray, cv::COLOR_BGR2GRAY);
+
+        if (!t_mask.empty() &&
+            static_cast<size_t>(cv::countNonZero(t_mask)) != t_mask.total()) {
+            full.mask = t_mask;
+        }
+        cv::meanStdDev(full.bgr, mean_, stddev_, full.mask);
+        levels_.push_back(std::move(full));
+
+        for (int i = 0; i < pyramid_.levels; i++) {
+            const level& prev = levels_.back();
+            // a level smaller than this cant be told apart from noise anymore.
+            if (prev.bgr.cols < 8 || prev.bgr.rows < 8) { break; }
+
+            level next;
+            cv::pyrDown(prev.bgr, next.bgr);
+            cv::pyrDown(prev.gray, next.gray);
+            if (!prev.mask.empty()) {
+                cv::resize(prev.mask, next.mask, next.bgr.size(), 0, 0,
+                           cv::INTER_NEAREST);
+            }
+            levels_.push_back(std::move(next));
+        }
+    }
+
+    const cv::Mat& prepared_template::get_image(const bool grayscale,
+                                                const int level) const
+    {
+        const auto& lvl = levels_.at(level);
+        return grayscale ? lvl.gray : lvl.bgr;
+    }
+
+    const cv::Mat& prepared_template::get_mask(const int level) const
+    {
+        return levels_.at(level).mask;
+    }
+}
@@ -0,0 +1,230 @@
+#include "asa/vision/template_match.h"
+
+#include "asa/core/thread_pool.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace asa::vision
+{
+    namespace
+    {
+        constexpr float NO_SCORE = std::numeric_limits<float>::lowest();
+
+        // matches the full scale template within the window of a coarse candidate.
+        scored_match refine(const prepared_source& source,
+                            const prepared_template& _template,
+                            const cv::Point& candidate, const int scale, const int mode)
+        {
+            const cv::Mat& image = source.get_image();
+            const bool grayscale = source.is_grayscale();
+
+            // a coarse peak may be off by a pixel in either direction after blurring.
+            const int margin = 2 * scale;
+            const cv::Size size = _template.get_size();
+            const cv::Rect window = cv::Rect(candidate.x * scale - margin,
+                                             candidate.y * scale - margin,
+                                             size.width + 2 * margin,
+                                             size.height + 2 * margin) &
+                                    cv::Rect(0, 0, image.cols, image.rows);
+
+            if (window.width < size.width || window.height < size.height) {
+                return {{}, NO_SCORE};
+            }
+
+            const cv::Mat scores = match_scores(image(window),
+                                                _template.get_image(grayscale),
+                                                _template.get_mask(), mode);
+
+            double max_val;
+            cv::Point max_loc;
+            cv::minMaxLoc(scores, nullptr, &max_val, nullptr, &max_loc);
+            return {
+                {window.x + max_loc.x, window.y + max_loc.y, size.width, size.height},
+                static_cast<float>(max_val)
+            };
+        }
+
+        // matches the template at its coarsest level first, then refines the best
+        // candidates at full scale. the best refined score is written to top.
+        std::vector<scored_match> match_coarse_to_fine(
+            const prepared_source& source, const prepared_template& _template,
+            const int levels, const float threshold, const size_t max_candidates,
+            const int mode, float& top)
+        {
+            const cv::Mat& coarse_template = _template.get_image(source.is_grayscale(),
+                                                                 levels);
+            const cv::Mat scores = match_scores(source.get_image(levels),
+                                                coarse_template,
+                                                _template.get_mask(levels), mode);
+
+            const float min_score = threshold - _template.get_pyramid_options().slack;
+            const auto candidates = find_peaks(scores, coarse_template.size(),
+                                               min_score, max_candidates);
+
+            // without candidates the coarse score is the best estimate we have.
+            if (candidates.empty()) {
+                double coarse_best;
+                cv::minMaxLoc(scores, nullptr, &coarse_best);
+                top = static_cast<float>(coarse_best);
+                return {};
+            }
+
+            std::vector<scored_match> ret;
+            top = NO_SCORE;
+            for (const auto& candidate: candidates) {
+                const scored_match refined = refine(source, _template,
+                                                    candidate.rect.tl(), 1 << levels,
+                                                    mode);
+                top = std::max(top, refined.score);
+                if (refined.score >= threshold) { ret.push_back(refined); }
+            }
+
+            // two coarse candidates may refine to (almost) the same location.
+            suppress_overlapping(ret);
+            return ret;
+        }
+
+        bool fits(const cv::Mat& source, const cv::Size& size)
+        {
+            return source.cols >= size.width && source.rows >= size.height;
+        }
+    }
+
+    prepared_source::prepared_source(const cv::Mat& t_source, const bool t_grayscale,
+                                     const int t_pyramid_levels)
+        : grayscale_(t_grayscale)
+    {
+        if (t_grayscale) {
+            levels_.push_back(to_gray(t_source));
+        } else if (t_source.channels() == 4) {
+            levels_.emplace_back();
+            cv::cvtColor(t_source, levels_.back(), cv::COLOR_BGRA2BGR);
+        } else {
+            levels_.push_back(t_source);
+        }
+
+        for (int i = 0; i < t_pyramid_levels; i++) {
+            cv::Mat next;
+            cv::pyrDown(levels_.back(), next);
+            levels_.push_back(std::move(next));
+        }
+    }
+
+    const cv::Mat& prepared_source::get_image(const int level) const
+    {
+        return levels_.at(level);
+    }
+
+    cv::Mat to_gray(const cv::Mat& src)
+    {
+        if (src.channels() == 1) { return src; }
+
+        cv::Mat gray;
+        cv::cvtColor(src, gray,
+                     src.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+        return gray;
+    }
+
+    cv::Mat match_scores(const cv::Mat& source, const cv::Mat& _template,
+                         const cv::Mat& mask, const int mode)
+    {
+        cv::Mat result;
+        if (mask.empty()) {
+            cv::matchTemplate(source, _template, result, mode);
+        } else {
+            cv::matchTemplate(source, _template, result, mode, mask);
+        }
+
+        if (mode == cv::TM_SQDIFF || mode == cv::TM_SQDIFF_NORMED) {
+            result = 1.0 - result;
+        }
+        return result;
+    }
+
+    int get_usable_pyramid_levels(const prepared_template& _template,
+                                  const cv::Size& source)
+    {
+        const int levels = _template.get_pyramid_levels();
+        if (levels == 0) { return 0; }
+
+        // matching the full template is cheap enough on a source this small.
+        const cv::Size size = _template.get_size();
+        if (source.area() < 4 * size.area()) { return 0; }
+
+        const cv::Mat& coarse = _template.get_image(false, levels);
+        const bool fits_coarse = (source.width >> levels) >= coarse.cols &&
+                                 (source.height >> levels) >= coarse.rows;
+        return fits_coarse ? levels : 0;
+    }
+
+    scored_match best_match(const prepared_source& source,
+                            const prepared_template& _template, const float threshold,
+                            const int mode)
+    {
+        const cv::Mat& image = source.get_image();
+        if (!fits(image, _template.get_size())) { return {{}, NO_SCORE}; }
+
+        const int levels = std::min(get_usable_pyramid_levels(_template, image.size()),
+                                    source.get_pyramid_levels());
+        if (levels > 0) {
+            float top;
+            const auto matches = match_coarse_to_fine(
+                source, _template, levels, threshold,
+                _template.get_pyramid_options().max_candidates, mode, top);
+
+            if (matches.empty()) { return {{}, top}; }
+            return matches.front();
+        }
+
+        const cv::Mat& templ = _template.get_image(source.is_grayscale());
+        const cv::Mat scores = match_scores(image, templ, _template.get_mask(), mode);
+
+        double max_val;
+        cv::Point max_loc;
+        cv::minMaxLoc(scores, nullptr, &max_val, nullptr, &max_loc);
+        return {cv::Rect(max_loc, _template.get_size()), static_cast<float>(max_val)};
+    }
+
+    std::vector<scored_match> all_matches(const prepared_source& source,
+                                          const prepared_template& _template,
+                                          const float threshold)
+    {
+        const cv::Mat& image = source.get_image();
+        if (!fits(image, _template.get_size())) { return {}; }
+
+        const int levels = std::min(get_usable_pyramid_levels(_template, image.size()),
+                                    source.get_pyramid_levels());
+        if (levels > 0) {
+            float top;
+            return match_coarse_to_fine(source, _template, levels, threshold,
+                                        std::numeric_limits<size_t>::max(),
+                                        cv::TM_CCOEFF_NORMED, top);
+        }
+
+        const cv::Mat& templ = _template.get_image(source.is_grayscale());
+        const cv::Mat scores = match_scores(image, templ, _template.get_mask(),
+                                            cv::TM_CCOEFF_NORMED);
+        return find_peaks(scores, _template.get_size(), threshold);
+    }
+
+    std::vector<scored_match> match_batch(
+        const cv::Mat& source, const std::span<const prepared_template* const> templates,
+        const float threshold, const bool grayscale, const int mode,
+        const unsigned int max_threads)
+    {
+        // downscale the source once as far as the deepest template needs it.
+        int levels = 0;
+        for (const prepared_template* _template: templates) {
+            levels = std::max(levels,
+                              get_usable_pyramid_levels(*_template, source.size()));
+        }
+        const prepared_source prepared(source, grayscale, levels);
+
+        std::vector<scored_match> ret(templates.size());
+        get_thread_pool().parallel_for(0, templates.size(), [&](const size_t i) -> void {
+            ret[i] = best_match(prepared, *templates[i], threshold, mode);
+        }, TaskPriority::NORMAL, max_threads);
+        return ret;
+    }
+}
@@ -0,0 +1,212 @@
+#include "asa/game/asset_pack.h"
+#include "asa/game/exceptions.h"
+
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <opencv2/imgcodecs.hpp>
+
+namespace asa
+{
+    namespace
+    {
+        constexpr uint8_t RAW = 0;
+        constexpr uint8_t PNG = 1;
+        constexpr uint8_t DATA = 2;
+
+        /**
+         * @brief Writes packs in the layout of embed.py, see there.
+         */
+        class pack_writer
+        {
+        public:
+            void add(const std::string& name, const cv::Mat& image, const bool png)
+            {
+                std::vector<uint8_t> blob;
+                if (png) {
+                    cv::imencode(".png", image, blob);
+                } else {
+                    blob.assign(image.data, image.data + image.total() * image.elemSize());
+                }
+                entries_.push_back({name, png ? PNG : RAW, image.rows, image.cols,
+                                    image.type(), std::move(blob)});
+            }
+
+            void add(const std::string& name, const std::string_view data)
+            {
+                entries_.push_back({name, DATA, 0, 0, 0, {data.begin(), data.end()}});
+            }
+
+            std::vector<uint8_t> build() const
+            {
+                std::vector<uint8_t> index{'A', 'S', 'A', 'P', 'A', 'C', 'K', 1};
+                put(index, static_cast<uint32_t>(entries_.size()));
+                put(index, uint32_t{0});
+
+                size_t offset = index.size();
+                for (const entry& e: entries_) { offset += 32 + e.name.size(); }
+
+                std::vector<uint8_t> blobs;
+                for (const entry& e: entries_) {
+                    blobs.resize(blobs.size() + (16 - (offset + blobs.size()) % 16) % 16);
+                    put(index, static_cast<uint64_t>(offset + blobs.size()));
+                    put(index, static_cast<uint64_t>(e.blob.size()));
+                    put(index, e.rows);
+                    put(index, e.cols);
+                    put(index, e.type);
+                    put(index, e.encoding);
+                    put(index, uint8_t{0});
+                    put(index, static_cast<uint16_t>(e.name.size()));
+                    index.insert(index.end(), e.name.begin(), e.name.end());
+                    blobs.insert(blobs.end(), e.blob.begin(), e.blob.end());
+                }
+                index.insert(index.end(), blobs.begin(), blobs.end());
+                return index;
+            }
+
+        private:
+            struct entry
+            {
+                std::string name;
+                uint8_t encoding;
+                int32_t rows;
+                int32_t cols;
+                int32_t type;
+                std::vector<uint8_t> blob;
+            };
+
+            template<typename T>
+            static void put(std::vector<uint8_t>& dst, const T value)
+            {
+                uint8_t bytes[sizeof(T)];
+                std::memcpy(bytes, &value, sizeof(T));
+                dst.insert(dst.end(), bytes, bytes + sizeof(T));
+            }
+
+            std::vector<entry> entries_;
+        };
+
+        cv::Mat make_image(const int channels)
+        {
+            cv::Mat image(12, 20, CV_8UC(channels));
+            for (int i = 0; i < static_cast<int>(image.total() * image.elemSize()); i++) {
+                image.data[i] = static_cast<uint8_t>(i * 7);
+            }
+            return image;
+        }
+
+        bool equal(const cv::Mat& a, const cv::Mat& b)
+        {
+            return a.size() == b.size() && a.type() == b.type() &&
+                   std::memcmp(a.data, b.data, a.total() * a.elemSize()) == 0;
+        }
+
+        class asset_pack_test : public testing::Test
+        {
+        protected:
+            void SetUp() override
+            {
+                const auto* info = testing::UnitTest::GetInstance()->current_test_info();
+                path_ = std::filesystem::temp_directory_path() /
+                        (std::string("asapp_pack_") + info->name() + ".pack");
+            }
+
+            void TearDown() override { std::filesystem::remove(path_); }
+
+            void write(const std::vector<uint8_t>& data) const
+            {
+                std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+                out.write(reinterpret_cast<const char*>(data.data()),
+                          static_cast<std::streamsize>(data.size()));
+            }
+
+            std::filesystem::path path_;
+        };
+    }
+
+    TEST_F(asset_pack_test, reads_raw_images_in_place)
+    {
+        const cv::Mat color = make_image(3);
+        const cv::Mat mask = make_image(1);
+        pack_writer writer;
+        writer.add("items/stone_inventory", color, false);
+        writer.add("items/stone_inventory_mask", mask, false);
+        write(writer.build());
+
+        const asset_pack pack(path_);
+        EXPECT_EQ(pack.size(), 2u);
+        EXPECT_TRUE(pack.contains("items/stone_inventory"));
+        EXPECT_FALSE(pack.contains("items/stone"));
+
+        const cv::Mat& image = pack.get("items/stone_inventory");
+        EXPECT_TRUE(equal(image, color));
+        EXPECT_TRUE(equal(pack.get("items/stone_inventory_mask"), mask));
+
+        // the image is only set up once and then handed out by reference.
+        EXPECT_EQ(&pack.get("items/stone_inventory"), &image);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(image.data) % 16, 0u);
+    }
+
+    TEST_F(asset_pack_test, decodes_png_images)
+    {
+        const cv::Mat color = make_image(3);
+        pack_writer writer;
+        writer.add("text/resume", color, true);
+        write(writer.build());
+
+        const asset_pack pack(path_);
+        EXPECT_TRUE(equal(pack.get("text/resume"), color));
+    }
+
+    TEST_F(asset_pack_test, keeps_images_and_data_apart)
+    {
+        pack_writer writer;
+        writer.add("itemdata.json", R"({"Stone": {}})");
+        writer.add("text/resume", make_image(1), false);
+        write(writer.build());
+
+        const asset_pack pack(path_);
+        EXPECT_EQ(pack.get_data("itemdata.json"), R"({"Stone": {}})");
+        EXPECT_THROW((void)pack.get("itemdata.json"), asset_not_found);
+        EXPECT_THROW((void)pack.get_data("text/resume"), asset_not_found);
+        EXPECT_THROW((void)pack.get("text/accept"), asset_not_found);
+    }
+
+    TEST_F(asset_pack_test, rejects_files_that_are_not_packs)
+    {
+        EXPECT_THROW(asset_pack{path_}, asset_pack_error);
+
+        write({});
+        EXPECT_THROW(asset_pack{path_}, asset_pack_error);
+
+        std::vector<uint8_t> data = pack_writer().build();
+        data[7] = 2;
+        write(data);
+        EXPECT_THROW(asset_pack{path_}, asset_pack_error);
+    }
+
+    TEST_F(asset_pack_test, rejects_truncated_packs)
+    {
+        pack_writer writer;
+        writer.add("text/resume", make_image(3), false);
+        const std::vector<uint8_t> data = writer.build();
+
+        // the blob, the name and the entry itself cut off in turn.
+        for (const size_t size: {data.size() - 1, size_t{16 + 32 + 4}, size_t{20}}) {
+            write({data.begin(), data.begin() + static_cast<ptrdiff_t>(size)});
+            EXPECT_THROW(asset_pack{path_}, asset_pack_error) << size;
+        }
+    }
+
+    TEST_F(asset_pack_test, rejects_raw_images_of_the_wrong_size)
+    {
+        pack_writer writer;
+        writer.add("text/resume", make_image(3), false);
+        std::vector<uint8_t> data = writer.build();
+
+        // claim one more row than the blob holds.
+        data[16 + 16]++;
+        write(data);
+        EXPECT_THROW(asset_pack{path_}, asset_pack_error);
+    }
+}
@@ -0,0 +1,67 @@
+#include "asa/vision/perceptual_hash.h"
+
+#include <gtest/gtest.h>
+
+namespace asa::vision
+{
+    namespace
+    {
+        cv::Mat make_row()
+        {
+            cv::Mat row(20, 350, CV_8UC3, cv::Scalar(30, 30, 30));
+            for (int x = 10; x < 340; x += 12) {
+                row(cv::Rect(x, 5, 6, 10)).setTo(cv::Scalar(192, 192, 192));
+            }
+            return row;
+        }
+    }
+
+    TEST(fingerprint_set, knows_inserted_fingerprints)
+    {
+        fingerprint_set set(4);
+        const uint64_t hash = content_hash(make_row());
+
+        EXPECT_FALSE(set.contains(hash));
+        EXPECT_TRUE(set.insert(hash));
+        EXPECT_TRUE(set.contains(hash));
+        EXPECT_FALSE(set.insert(hash));
+        EXPECT_EQ(set.get_size(), 1u);
+    }
+
+    TEST(fingerprint_set, tells_apart_rows_with_the_same_difference_hash)
+    {
+        const cv::Mat row = make_row();
+        cv::Mat changed = row.clone();
+        changed.at<cv::Vec3b>(7, 12) = {200, 200, 200};
+
+        ASSERT_EQ(dhash(row), dhash(changed));
+
+        fingerprint_set set(4);
+        set.insert(content_hash(row));
+        EXPECT_FALSE(set.contains(content_hash(changed)));
+    }
+
+    TEST(fingerprint_set, hashes_the_content_of_a_roi)
+    {
+        cv::Mat frame(100, 400, CV_8UC3, cv::Scalar(0, 0, 0));
+        cv::Mat roi = frame(cv::Rect(30, 40, 350, 20));
+        make_row().copyTo(roi);
+
+        EXPECT_EQ(content_hash(roi), content_hash(make_row()));
+    }
+
+    TEST(fingerprint_set, drops_the_oldest_fingerprint_at_capacity)
+    {
+        fingerprint_set set(2);
+        set.insert(1);
+        set.insert(2);
+        set.insert(3);
+        EXPECT_EQ(set.get_size(), 2u);
+        EXPECT_FALSE(set.contains(1));
+        EXPECT_TRUE(set.contains(2));
+        EXPECT_TRUE(set.contains(3));
+
+        set.clear();
+        EXPECT_FALSE(set.contains(3));
+    }
+}
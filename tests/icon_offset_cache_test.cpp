@@ -0,0 +1,126 @@
+#include "asa/ui/components/icon_offset_cache.h"
+
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+namespace asa
+{
+    namespace
+    {
+        const cv::Rect WINDOW{7, 7, 72, 72};
+        const cv::Rect MOVED{3, 10, 72, 72};
+    }
+
+    TEST(icon_offset_cache, learns_and_forgets_windows)
+    {
+        icon_offset_cache cache;
+        EXPECT_FALSE(cache.find("Metal Ingot"));
+
+        cache.learn("Metal Ingot", WINDOW, 0.9f);
+        const auto entry = cache.find("Metal Ingot");
+        ASSERT_TRUE(entry);
+        EXPECT_EQ(entry->window, WINDOW);
+        EXPECT_FLOAT_EQ(entry->confidence, 0.9f);
+        EXPECT_EQ(cache.size(), 1u);
+
+        cache.forget("Metal Ingot");
+        EXPECT_FALSE(cache.find("Metal Ingot"));
+        EXPECT_EQ(cache.size(), 0u);
+    }
+
+    TEST(icon_offset_cache, keeps_windows_that_are_only_unmatched)
+    {
+        icon_offset_cache cache(8, 4);
+        cache.learn("Metal Ingot", WINDOW, 0.9f);
+
+        // an item that is not in the slot never costs its window.
+        int verifications = 0;
+        for (int i = 0; i < 100; i++) { verifications += cache.unmatched("Metal Ingot"); }
+        EXPECT_EQ(verifications, 12);
+
+        const auto entry = cache.find("Metal Ingot");
+        ASSERT_TRUE(entry);
+        EXPECT_EQ(entry->window, WINDOW);
+        EXPECT_EQ(entry->misses, 0);
+        EXPECT_FALSE(cache.unmatched("Stone"));
+    }
+
+    TEST(icon_offset_cache, moves_the_window_on_a_miss)
+    {
+        icon_offset_cache cache(8, 4);
+        cache.learn("Metal Ingot", WINDOW, 0.9f);
+        cache.unmatched("Metal Ingot");
+        cache.miss("Metal Ingot", MOVED, 0.95f);
+
+        const auto entry = cache.find("Metal Ingot");
+        ASSERT_TRUE(entry);
+        EXPECT_EQ(entry->window, MOVED);
+        EXPECT_EQ(entry->misses, 1);
+        EXPECT_EQ(entry->unmatched, 0);
+
+        cache.hit("Metal Ingot", 0.95f);
+        EXPECT_EQ(cache.find("Metal Ingot")->misses, 0);
+    }
+
+    TEST(icon_offset_cache, drops_windows_that_keep_missing)
+    {
+        icon_offset_cache cache(8, 4);
+        cache.learn("Metal Ingot", WINDOW, 0.9f);
+        for (int i = 0; i < 3; i++) { cache.miss("Metal Ingot", MOVED, 0.9f); }
+        EXPECT_TRUE(cache.find("Metal Ingot"));
+
+        cache.miss("Metal Ingot", WINDOW, 0.9f);
+        EXPECT_FALSE(cache.find("Metal Ingot"));
+    }
+
+    TEST(icon_offset_cache, averages_the_confidence_of_hits)
+    {
+        icon_offset_cache cache;
+        cache.learn("Metal Ingot", WINDOW, 0.8f);
+        cache.hit("Metal Ingot", 1.f);
+
+        const float confidence = cache.find("Metal Ingot")->confidence;
+        EXPECT_GT(confidence, 0.8f);
+        EXPECT_LT(confidence, 1.f);
+    }
+
+    TEST(icon_offset_cache, saves_and_loads_the_windows)
+    {
+        const auto path = std::filesystem::temp_directory_path() /
+                          "asapp_icon_offsets.txt";
+        {
+            icon_offset_cache cache;
+            cache.learn("Metal Ingot", WINDOW, 0.9f);
+            cache.learn("Stone", MOVED, 0.8f);
+            ASSERT_TRUE(cache.save(path));
+        }
+
+        icon_offset_cache cache;
+        ASSERT_TRUE(cache.load(path));
+        std::filesystem::remove(path);
+
+        EXPECT_EQ(cache.size(), 2u);
+        EXPECT_EQ(cache.find("Metal Ingot")->window, WINDOW);
+        EXPECT_EQ(cache.find("Stone")->window, MOVED);
+        EXPECT_FALSE(cache.load(path));
+    }
+
+    TEST(icon_offset_cache, is_safe_to_use_from_many_threads)
+    {
+        icon_offset_cache cache;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; t++) {
+            threads.emplace_back([&cache, t] {
+                for (int i = 0; i < 1000; i++) {
+                    const std::string item = "item " + std::to_string((t + i) % 32);
+                    if (!cache.find(item)) { cache.learn(item, WINDOW, 0.9f); }
+                    if (i % 3 == 0) { cache.hit(item, 0.9f); }
+                    else if (cache.unmatched(item)) { cache.miss(item, MOVED, 0.9f); }
+                }
+            });
+        }
+        for (std::thread& thread: threads) { thread.join(); }
+        EXPECT_LE(cache.size(), 32u);
+    }
+}
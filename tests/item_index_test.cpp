@@ -0,0 +1,112 @@
+#include "asa/items/item_index.h"
+#include "asa/items/items.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+
+namespace asa
+{
+    namespace
+    {
+        // a red square on a blue background, only the square is visible.
+        cv::Mat make_icon(cv::Mat& mask)
+        {
+            cv::Mat icon(62, 62, CV_8UC3, cv::Scalar(200, 40, 40));
+            icon(cv::Rect(16, 16, 30, 30)).setTo(cv::Scalar(30, 30, 220));
+            mask = cv::Mat(62, 62, CV_8U, cv::Scalar(0));
+            mask(cv::Rect(16, 16, 30, 30)).setTo(cv::Scalar(255));
+            return icon;
+        }
+
+        /**
+         * @brief Gets all items, nullptr if they can not be loaded because the asset
+         * pack is missing.
+         */
+        const std::map<std::string, std::unique_ptr<item> >* get_items()
+        {
+            static const auto* items = []() -> decltype(&get_all_items()) {
+                try {
+                    load_items();
+                    return &get_all_items();
+                } catch (const std::exception&) { return nullptr; }
+            }();
+            return items;
+        }
+    }
+
+    TEST(item_index, describes_only_the_visible_pixels)
+    {
+        cv::Mat mask;
+        const cv::Mat icon = make_icon(mask);
+        cv::Mat other_background = icon.clone();
+        other_background(cv::Rect(0, 0, 62, 10)).setTo(cv::Scalar(0, 255, 0));
+
+        const auto a = item_index::describe(icon, mask);
+        const auto b = item_index::describe(other_background, mask);
+        EXPECT_EQ(a.histogram, b.histogram);
+        EXPECT_EQ(a.hash, b.hash);
+
+        int total = 0;
+        for (const uint8_t share: a.histogram) { total += share; }
+        EXPECT_EQ(total, 255);
+    }
+
+    TEST(item_index, measures_the_distance_of_descriptors)
+    {
+        cv::Mat mask;
+        const cv::Mat icon = make_icon(mask);
+        const auto masked = item_index::describe(icon, mask);
+        const auto full = item_index::describe(icon, cv::Mat());
+
+        EXPECT_FLOAT_EQ(item_index::distance(masked, masked), 0.f);
+        EXPECT_GT(item_index::distance(masked, full), 0.f);
+        EXPECT_LE(item_index::distance(masked, full), 1.f);
+        EXPECT_FLOAT_EQ(item_index::distance(masked, full),
+                        item_index::distance(full, masked));
+    }
+
+    TEST(item_index, shortlists_the_exact_icon_first)
+    {
+        const auto* items = get_items();
+        if (!items) { GTEST_SKIP() << "The asset pack could not be loaded."; }
+
+        item_index index;
+        for (const auto& [name, item]: *items) { index.add(*item); }
+        ASSERT_EQ(index.size(), items->size());
+
+        for (const auto& [name, item]: *items) {
+            const auto query = item_index::describe(item->get_inventory_icon(),
+                                                    item->get_inventory_icon_mask());
+            const auto candidates = index.shortlist(query, 8);
+            ASSERT_EQ(candidates.size(), 8u);
+            EXPECT_FLOAT_EQ(candidates.front().distance, 0.f) << name;
+
+            // items may share an icon, but the item has to be among the exact ones.
+            EXPECT_TRUE(std::ranges::any_of(candidates, [&item](const auto& c) {
+                return c.match == item.get() && c.distance == 0.f;
+            })) << name;
+            EXPECT_TRUE(std::ranges::is_sorted(candidates, {},
+                                               &item_index::candidate::distance));
+        }
+    }
+
+    TEST(item_index, shortlists_only_the_items_that_pass_the_filter)
+    {
+        const auto* items = get_items();
+        if (!items) { GTEST_SKIP() << "The asset pack could not be loaded."; }
+
+        item_index index;
+        for (const auto& [name, item]: *items) { index.add(*item); }
+
+        const item& first = *items->begin()->second;
+        const auto query = item_index::describe(first.get_inventory_icon(),
+                                                first.get_inventory_icon_mask());
+        const auto candidates = index.shortlist(query, 8, [&first](const item& i) {
+            return &i != &first;
+        });
+        EXPECT_TRUE(std::ranges::none_of(candidates, [&first](const auto& c) {
+            return c.match == &first;
+        }));
+        EXPECT_TRUE(index.shortlist(query, 0).empty());
+    }
+}
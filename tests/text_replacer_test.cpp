@@ -0,0 +1,75 @@
+#include "asa/core/text_replacer.h"
+
+#include <gtest/gtest.h>
+
+namespace asa
+{
+    TEST(text_replacer, replaces_every_pattern_in_one_pass)
+    {
+        const text_replacer replacer({{"kilied", "killed"}, {"Lvb", "Lvl"}});
+
+        size_t replaced = 0;
+        EXPECT_EQ(replacer.replace("Rex - Lvb 1 was kilied by Giga - Lvb 2", &replaced),
+                  "Rex - Lvl 1 was killed by Giga - Lvl 2");
+        EXPECT_EQ(replaced, 3u);
+    }
+
+    TEST(text_replacer, keeps_text_without_matches)
+    {
+        const text_replacer replacer({{"abc", "x"}});
+
+        size_t replaced = 1;
+        EXPECT_EQ(replacer.replace("ab bc ca", &replaced), "ab bc ca");
+        EXPECT_EQ(replaced, 0u);
+        EXPECT_EQ(replacer.replace(""), "");
+    }
+
+    TEST(text_replacer, prefers_the_leftmost_match)
+    {
+        const text_replacer replacer({{"bcd", "X"}, {"ab", "Y"}});
+
+        EXPECT_EQ(replacer.replace("abcd"), "Ycd");
+    }
+
+    TEST(text_replacer, prefers_the_longest_of_matches_at_the_same_start)
+    {
+        const text_replacer replacer({{"- Lv", "A"}, {"- Lv ", "B"}, {"-", "C"}});
+
+        EXPECT_EQ(replacer.replace("x - Lv 5"), "x B5");
+        EXPECT_EQ(replacer.replace("x - Lvl"), "x Al");
+        EXPECT_EQ(replacer.replace("x -y"), "x Cy");
+    }
+
+    TEST(text_replacer, finds_a_longer_match_that_starts_earlier)
+    {
+        // "bc" is found first, but "abcd" starts before it.
+        const text_replacer replacer({{"bc", "X"}, {"abcd", "Y"}});
+
+        EXPECT_EQ(replacer.replace("abcd"), "Y");
+        EXPECT_EQ(replacer.replace("abce"), "aXe");
+    }
+
+    TEST(text_replacer, searches_again_after_a_replaced_match)
+    {
+        const text_replacer replacer({{"aa", "a"}});
+
+        size_t replaced = 0;
+        EXPECT_EQ(replacer.replace("aaaa", &replaced), "aa");
+        EXPECT_EQ(replaced, 2u);
+    }
+
+    TEST(text_replacer, uses_the_last_of_duplicate_patterns)
+    {
+        const text_replacer replacer({{"x", "1"}, {"", "ignored"}, {"x", "2"}});
+
+        EXPECT_EQ(replacer.replace("axb"), "a2b");
+    }
+
+    TEST(text_replacer, handles_newlines_and_bytes_outside_the_patterns)
+    {
+        const text_replacer replacer({{"\"\n", "- "}, {"\n", " "}});
+
+        EXPECT_EQ(replacer.replace("Bed\"\n(Pin Coded)\n\xC3\xA9"),
+                  "Bed- (Pin Coded) \xC3\xA9");
+    }
+}
@@ -0,0 +1,178 @@
+#include "asa/ui/tribelog_store.h"
+#include "asa/core/exceptions.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace asa
+{
+    namespace
+    {
+        using EventType = tribelog_message::EventType;
+
+        tribelog_message make_message(const int32_t day, const std::string& content,
+                                      const EventType type = EventType::DEMOLISHED)
+        {
+            tribelog_message ret;
+            ret.time = {day, 12, 30, 15};
+            ret.type = type;
+            ret.content = content;
+            ret.raw_text = "Day " + std::to_string(day) + ", 12:30:15: " + content;
+            return ret;
+        }
+
+        class tribelog_store_test : public testing::Test
+        {
+        protected:
+            void SetUp() override
+            {
+                const auto* info = testing::UnitTest::GetInstance()->current_test_info();
+                directory_ = std::filesystem::temp_directory_path() /
+                             (std::string("asapp_tribelog_") + info->name());
+                std::filesystem::remove_all(directory_);
+            }
+
+            void TearDown() override { std::filesystem::remove_all(directory_); }
+
+            std::filesystem::path directory_;
+        };
+    }
+
+    TEST_F(tribelog_store_test, appends_and_rejects_duplicates)
+    {
+        tribelog_store store(directory_, false);
+        EXPECT_TRUE(store.empty());
+
+        EXPECT_TRUE(store.append(make_message(10, "Human demolished a Wall")));
+        EXPECT_TRUE(store.append(make_message(10, "Human demolished a Bed")));
+        EXPECT_FALSE(store.append(make_message(10, "Human demolished a Wall")));
+
+        EXPECT_EQ(store.size(), 2u);
+        EXPECT_TRUE(store.contains(make_message(10, "Human demolished a Bed")));
+        EXPECT_FALSE(store.contains(make_message(11, "Human demolished a Bed")));
+    }
+
+    TEST_F(tribelog_store_test, queries_by_time_and_type)
+    {
+        tribelog_store store(directory_, false);
+        store.append(make_message(12, "c", EventType::DINO_TAMED));
+        store.append(make_message(10, "a"));
+        store.append(make_message(11, "b", EventType::DINO_TAMED));
+
+        const auto all = store.range({10, 0, 0, 0}, {11, 23, 59, 59});
+        ASSERT_EQ(all.size(), 2u);
+        EXPECT_EQ(all[0].content, "a");
+        EXPECT_EQ(all[1].content, "b");
+        EXPECT_EQ(all[1].type, EventType::DINO_TAMED);
+        EXPECT_EQ(all[1].raw_text, "Day 11, 12:30:15: b");
+
+        const auto tamed = store.range({0, 0, 0, 0}, {99, 0, 0, 0},
+                                       EventType::DINO_TAMED);
+        ASSERT_EQ(tamed.size(), 2u);
+        EXPECT_EQ(tamed[0].content, "b");
+        EXPECT_EQ(tamed[1].content, "c");
+
+        EXPECT_EQ(store.get_latest_time(), (tribelog_message::timestamp{12, 12, 30, 15}));
+    }
+
+    TEST_F(tribelog_store_test, gets_the_latest_messages_newest_first)
+    {
+        tribelog_store store(directory_, false);
+        for (int day = 1; day <= 5; day++) {
+            store.append(make_message(day, std::to_string(day)));
+        }
+
+        const auto latest = store.latest(3);
+        ASSERT_EQ(latest.size(), 3u);
+        EXPECT_EQ(latest[0].content, "5");
+        EXPECT_EQ(latest[2].content, "3");
+        EXPECT_TRUE(latest[0].raw_image.empty());
+    }
+
+    TEST_F(tribelog_store_test, reloads_the_messages_when_reopened)
+    {
+        {
+            tribelog_store store(directory_, false);
+            store.append(make_message(1, "a"));
+            store.append(make_message(2, "b"));
+        }
+
+        tribelog_store store(directory_, false);
+        EXPECT_EQ(store.size(), 2u);
+        EXPECT_FALSE(store.append(make_message(2, "b")));
+        EXPECT_TRUE(store.append(make_message(3, "c")));
+        EXPECT_EQ(store.latest(1).front().content, "c");
+    }
+
+    TEST_F(tribelog_store_test, drops_an_incomplete_record_when_reopened)
+    {
+        {
+            tribelog_store store(directory_, false);
+            store.append(make_message(1, "a"));
+        }
+        {
+            // a record header that promises more than follows, as left by a crash.
+            std::ofstream out(directory_ / "tribelog-000000.log",
+                              std::ios::binary | std::ios::app);
+            out.write("\x20\x00\x00\x00\x00\x00\x00\x00abc", 11);
+        }
+
+        {
+            tribelog_store store(directory_, false);
+            EXPECT_EQ(store.size(), 1u);
+            EXPECT_TRUE(store.append(make_message(2, "b")));
+        }
+
+        tribelog_store store(directory_, false);
+        const auto all = store.range({0, 0, 0, 0}, {99, 0, 0, 0});
+        ASSERT_EQ(all.size(), 2u);
+        EXPECT_EQ(all[1].content, "b");
+    }
+
+    TEST_F(tribelog_store_test, starts_a_new_segment_when_full)
+    {
+        {
+            tribelog_store store(directory_, false, 64);
+            for (int day = 1; day <= 4; day++) {
+                store.append(make_message(day, "Human demolished a Wall"));
+            }
+        }
+        EXPECT_TRUE(std::filesystem::exists(directory_ / "tribelog-000001.log"));
+
+        tribelog_store store(directory_, false, 64);
+        const auto all = store.range({0, 0, 0, 0}, {99, 0, 0, 0});
+        ASSERT_EQ(all.size(), 4u);
+        EXPECT_EQ(all[3].time.day, 4);
+    }
+
+    TEST_F(tribelog_store_test, locks_the_directory)
+    {
+        {
+            tribelog_store store(directory_, false);
+            EXPECT_THROW(tribelog_store(directory_, false), asapp_error);
+        }
+        EXPECT_NO_THROW(tribelog_store(directory_, false));
+    }
+
+    TEST_F(tribelog_store_test, fails_if_the_thumbnails_can_not_be_opened)
+    {
+        // a directory in place of the thumbnails can not be opened for writing.
+        std::filesystem::create_directories(directory_ / "tribelog-000000.thumbs");
+        EXPECT_THROW(tribelog_store(directory_, true), asapp_error);
+    }
+
+    TEST_F(tribelog_store_test, keeps_thumbnails_of_the_images)
+    {
+        tribelog_store store(directory_, true);
+        tribelog_message msg = make_message(1, "a");
+        msg.raw_image = cv::Mat(20, 350, CV_8UC3, cv::Scalar(30, 60, 90));
+        store.append(msg);
+        store.append(make_message(2, "b"));
+
+        const auto latest = store.latest(2, true);
+        ASSERT_EQ(latest.size(), 2u);
+        EXPECT_TRUE(latest[0].raw_image.empty());
+        EXPECT_FALSE(latest[1].raw_image.empty());
+        EXPECT_TRUE(store.latest(2, false)[1].raw_image.empty());
+    }
+}